@@ -15,7 +15,23 @@
  *
  * Note: The original code wrote lines with "\r\n". We don't.
  *
+ * Rules (all kernels):
+ *  Encoding: A '\n' is written after every 76 characters of full 3 byte
+ *  groups. The final 1 or 2 bytes (with '=' padding) follow that.
+ *  Decoding: CR and LF are skipped anywhere. Decoding stops at the first '='.
+ *  Any other non-base64 character before that is an error.
+ *
+ * The SSE4.1/AVX2 kernels are based on the algorithms described by Wojciech
+ * Mula and Daniel Lemire ("Faster Base64 Encoding and Decoding Using AVX2
+ * Instructions", 2018). A block that contains anything other than base64
+ * characters (line breaks, padding, errors) is handled by the scalar code.
+ *
  * Revision History
+ * 2026-10-19 Decode takes a string_view.
+ * 2026-10-19 Added streaming encoder/decoder.
+ * 2026-10-19 Added SSE4.1/AVX2 kernels with runtime dispatch. Rewrote the
+ *            scalar code: the old decode loop indexed the table with signed
+ *            chars and read past the end on trailing line breaks.
  * 2020-02-29 Removed raw pointers, use vectors.
  * 2012-04-10 Based on wx-group thread, use std::string for internal use
  * 2009-09-13 Add support for wxWidgets 2.9, deprecate tstring.
@@ -29,6 +45,26 @@
 #include "ARBCommon/ARBBase64.h"
 
 #include "ARBCommon/StringUtil.h"
+#include <cstring>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define ARB_BASE64_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#else
+#define ARB_BASE64_X86 0
+#endif
+
+// gcc/clang only allow intrinsics in functions compiled for that target.
+#if defined(__GNUC__) || defined(__clang__)
+#define ARB_TARGET_SSE41 __attribute__((target("ssse3,sse4.1")))
+#define ARB_TARGET_AVX2  __attribute__((target("avx2")))
+#else
+#define ARB_TARGET_SSE41
+#define ARB_TARGET_AVX2
+#endif
 
 #ifdef __WXMSW__
 #include <wx/msw/msvcrt.h>
@@ -38,7 +74,14 @@
 
 namespace
 {
-constexpr unsigned int MaxLineLength = 76;
+using dconSoft::ARBCommon::ARBBase64::ARBBase64Kernel;
+
+constexpr size_t MaxLineLength = 76;
+// Number of input bytes that make a full line.
+constexpr size_t MaxLineBytes = MaxLineLength / 4 * 3;
+// Streaming: input processed per output buffer.
+constexpr size_t EncodeChunkBytes = 1024 * MaxLineBytes;
+constexpr size_t DecodeChunkChars = 64 * 1024;
 
 constexpr char base64chars[64] = {
 	// clang-format off
@@ -53,259 +96,709 @@ constexpr char base64chars[64] = {
 	// clang-format on
 };
 
-#define SKIP '\202'
+constexpr unsigned char BAD = 0xFF; // Not base64: error
+constexpr unsigned char EOL = 0xFE; // CR/LF: skipped
+constexpr unsigned char PAD = 0xFD; // '=': end of data
 
-constexpr char base64map[] = {
+constexpr unsigned char base64map[256] = {
 	// clang-format off
-	SKIP, SKIP, SKIP, SKIP, SKIP, SKIP, SKIP, SKIP,
-	SKIP, SKIP, SKIP, SKIP, SKIP, SKIP, SKIP, SKIP,
-	SKIP, SKIP, SKIP, SKIP, SKIP, SKIP, SKIP, SKIP,
-	SKIP, SKIP, SKIP, SKIP, SKIP, SKIP, SKIP, SKIP,
-	SKIP, SKIP, SKIP, SKIP, SKIP, SKIP, SKIP, SKIP,
-	SKIP, SKIP, SKIP, 62,   SKIP, SKIP, SKIP, 63,
+	BAD,  BAD,  BAD,  BAD,  BAD,  BAD,  BAD,  BAD,
+	BAD,  BAD,  EOL,  BAD,  BAD,  EOL,  BAD,  BAD,
+	BAD,  BAD,  BAD,  BAD,  BAD,  BAD,  BAD,  BAD,
+	BAD,  BAD,  BAD,  BAD,  BAD,  BAD,  BAD,  BAD,
+	BAD,  BAD,  BAD,  BAD,  BAD,  BAD,  BAD,  BAD,
+	BAD,  BAD,  BAD,  62,   BAD,  BAD,  BAD,  63,
 	52,   53,   54,   55,   56,   57,   58,   59,
-	60,   61,   SKIP, SKIP, SKIP, SKIP, SKIP, SKIP,
-	SKIP, 0,    1 ,   2 ,   3 ,   4 ,   5 ,   6 ,
-	7,    8 ,   9 ,   10,   11,   12,   13,   14,
+	60,   61,   BAD,  BAD,  BAD,  PAD,  BAD,  BAD,
+	BAD,  0,    1,    2,    3,    4,    5,    6,
+	7,    8,    9,    10,   11,   12,   13,   14,
 	15,   16,   17,   18,   19,   20,   21,   22,
-	23,   24,   25,   SKIP, SKIP, SKIP, SKIP, SKIP,
-	SKIP, 26,   27,   28,   29,   30,   31,   32,
+	23,   24,   25,   BAD,  BAD,  BAD,  BAD,  BAD,
+	BAD,  26,   27,   28,   29,   30,   31,   32,
 	33,   34,   35,   36,   37,   38,   39,   40,
 	41,   42,   43,   44,   45,   46,   47,   48,
-	49,   50,   51,   SKIP, SKIP, SKIP, SKIP, SKIP,
-	SKIP, SKIP, SKIP, SKIP, SKIP, SKIP, SKIP, SKIP,
-	SKIP, SKIP, SKIP, SKIP, SKIP, SKIP, SKIP, SKIP,
-	SKIP, SKIP, SKIP, SKIP, SKIP, SKIP, SKIP, SKIP,
-	SKIP, SKIP, SKIP, SKIP, SKIP, SKIP, SKIP, SKIP,
-	SKIP, SKIP, SKIP, SKIP, SKIP, SKIP, SKIP, SKIP,
-	SKIP, SKIP, SKIP, SKIP, SKIP, SKIP, SKIP, SKIP,
-	SKIP, SKIP, SKIP, SKIP, SKIP, SKIP, SKIP, SKIP,
-	SKIP, SKIP, SKIP, SKIP, SKIP, SKIP, SKIP, SKIP,
-	SKIP, SKIP, SKIP, SKIP, SKIP, SKIP, SKIP, SKIP,
-	SKIP, SKIP, SKIP, SKIP, SKIP, SKIP, SKIP, SKIP,
-	SKIP, SKIP, SKIP, SKIP, SKIP, SKIP, SKIP, SKIP,
-	SKIP, SKIP, SKIP, SKIP, SKIP, SKIP, SKIP, SKIP,
-	SKIP, SKIP, SKIP, SKIP, SKIP, SKIP, SKIP, SKIP,
-	SKIP, SKIP, SKIP, SKIP, SKIP, SKIP, SKIP, SKIP,
-	SKIP, SKIP, SKIP, SKIP, SKIP, SKIP, SKIP, SKIP,
-	SKIP, SKIP, SKIP, SKIP, SKIP, SKIP, SKIP, SKIP
+	49,   50,   51,   BAD,  BAD,  BAD,  BAD,  BAD,
+	BAD,  BAD,  BAD,  BAD,  BAD,  BAD,  BAD,  BAD,
+	BAD,  BAD,  BAD,  BAD,  BAD,  BAD,  BAD,  BAD,
+	BAD,  BAD,  BAD,  BAD,  BAD,  BAD,  BAD,  BAD,
+	BAD,  BAD,  BAD,  BAD,  BAD,  BAD,  BAD,  BAD,
+	BAD,  BAD,  BAD,  BAD,  BAD,  BAD,  BAD,  BAD,
+	BAD,  BAD,  BAD,  BAD,  BAD,  BAD,  BAD,  BAD,
+	BAD,  BAD,  BAD,  BAD,  BAD,  BAD,  BAD,  BAD,
+	BAD,  BAD,  BAD,  BAD,  BAD,  BAD,  BAD,  BAD,
+	BAD,  BAD,  BAD,  BAD,  BAD,  BAD,  BAD,  BAD,
+	BAD,  BAD,  BAD,  BAD,  BAD,  BAD,  BAD,  BAD,
+	BAD,  BAD,  BAD,  BAD,  BAD,  BAD,  BAD,  BAD,
+	BAD,  BAD,  BAD,  BAD,  BAD,  BAD,  BAD,  BAD,
+	BAD,  BAD,  BAD,  BAD,  BAD,  BAD,  BAD,  BAD,
+	BAD,  BAD,  BAD,  BAD,  BAD,  BAD,  BAD,  BAD,
+	BAD,  BAD,  BAD,  BAD,  BAD,  BAD,  BAD,  BAD,
+	BAD,  BAD,  BAD,  BAD,  BAD,  BAD,  BAD,  BAD
 	// clang-format on
 };
-} // namespace
 
 
-namespace dconSoft
+/////////////////////////////////////////////////////////////////////////////
+// Kernels
+//
+// EncodeBlocks: Encode whole blocks of 3 byte groups from 'in' (at most
+//   'len' bytes, a multiple of 3). Kernels may read up to 'readable' bytes.
+//   Returns the number of bytes consumed; 4/3 of that is written to 'out'.
+// DecodeBlocks: Decode whole blocks of 'in' as long as they contain only
+//   base64 characters. Returns the number of characters consumed (a multiple
+//   of 4); 3/4 of that is written to 'out' (and no more).
+
+typedef size_t (*EncodeBlocksFunc)(unsigned char const* in, size_t len, size_t readable, char* out);
+typedef size_t (*DecodeBlocksFunc)(char const* in, size_t len, unsigned char* out);
+
+struct Base64Kernel
 {
-namespace ARBCommon
+	EncodeBlocksFunc encode;
+	DecodeBlocksFunc decode;
+	size_t decodeBlock; // Characters per decode block
+};
+
+
+inline void EncodeGroup(unsigned char const* in, char* out)
 {
-namespace ARBBase64
+	uint32_t tmp = (static_cast<uint32_t>(in[0]) << 16) | (static_cast<uint32_t>(in[1]) << 8) | in[2];
+	out[0] = base64chars[(tmp >> 18) & 0x3F];
+	out[1] = base64chars[(tmp >> 12) & 0x3F];
+	out[2] = base64chars[(tmp >> 6) & 0x3F];
+	out[3] = base64chars[tmp & 0x3F];
+}
+
+
+#if ARB_BASE64_X86
+
+bool CpuHasSSE41()
 {
+#if defined(_MSC_VER)
+	int info[4];
+	__cpuid(info, 1);
+	return (info[2] & (1 << 9)) && (info[2] & (1 << 19)); // SSSE3, SSE4.1
+#else
+	return __builtin_cpu_supports("ssse3") && __builtin_cpu_supports("sse4.1");
+#endif
+}
 
-bool Decode(std::string const& inBase64, std::vector<unsigned char>& outBinData)
+
+bool CpuHasAVX2()
 {
-	outBinData.clear();
-	size_t outBytes = 0;
-	if (inBase64.empty())
+#if defined(_MSC_VER)
+	int info[4];
+	__cpuid(info, 0);
+	if (info[0] < 7)
+		return false;
+	__cpuid(info, 1);
+	// OSXSAVE and AVX, and the OS saves the YMM registers.
+	if (!(info[2] & (1 << 27)) || !(info[2] & (1 << 28)) || (_xgetbv(0) & 6) != 6)
 		return false;
+	__cpuidex(info, 7, 0);
+	return !!(info[1] & (1 << 5));
+#else
+	return __builtin_cpu_supports("avx2");
+#endif
+}
+
 
-	size_t bufsize = inBase64.length();
-	outBinData = std::vector<unsigned char>(bufsize);
-	unsigned char* result = outBinData.data();
+// 12 bytes (in the low 12 bytes of 'in') to 16 6bit values.
+ARB_TARGET_SSE41 inline __m128i EncodeReshuffleSSE(__m128i in)
+{
+	in = _mm_shuffle_epi8(in, _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+	__m128i t0 = _mm_and_si128(in, _mm_set1_epi32(0x0FC0FC00));
+	__m128i t1 = _mm_mulhi_epu16(t0, _mm_set1_epi32(0x04000040));
+	__m128i t2 = _mm_and_si128(in, _mm_set1_epi32(0x003F03F0));
+	__m128i t3 = _mm_mullo_epi16(t2, _mm_set1_epi32(0x01000010));
+	return _mm_or_si128(t1, t3);
+}
+
+
+// 6bit values to the base64 alphabet.
+ARB_TARGET_SSE41 inline __m128i EncodeTranslateSSE(__m128i in)
+{
+	// Offsets for: A-Z, a-z, 0-9 (indices 2-11), '+', '/'
+	__m128i const lut = _mm_setr_epi8(65, 71, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -19, -16, 0, 0);
+	__m128i indices = _mm_subs_epu8(in, _mm_set1_epi8(51));
+	__m128i mask = _mm_cmpgt_epi8(in, _mm_set1_epi8(25));
+	indices = _mm_sub_epi8(indices, mask);
+	return _mm_add_epi8(in, _mm_shuffle_epi8(lut, indices));
+}
 
-	int std = 0;
-	size_t count = 1;
-	size_t nChar = 0;
 
-	while (count <= bufsize && inBase64[nChar] != '=')
+ARB_TARGET_SSE41 size_t EncodeBlocksSSE41(unsigned char const* in, size_t len, size_t readable, char* out)
+{
+	size_t used = 0;
+	for (; used + 12 <= len && used + 16 <= readable; used += 12, out += 16)
 	{
-		// check to see if it's a legal base64 char...
-		while (SKIP == base64map[inBase64[nChar]])
-		{
-			if (inBase64[nChar] != '\r' && inBase64[nChar] != '\n')
-			{
-				// error in the encoded data.
-				outBinData.clear();
-				return false;
-			}
-			++nChar;
-			--bufsize;
-			if (count >= bufsize)
-				break;
-		}
+		__m128i str = _mm_loadu_si128(reinterpret_cast<__m128i const*>(in + used));
+		str = EncodeTranslateSSE(EncodeReshuffleSSE(str));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(out), str);
+	}
+	return used;
+}
 
-		// add the base64 char to std...
-		std |= base64map[inBase64[nChar++] & 0xFF];
-		std <<= 6;
-		if (count % 4 == 0) // we have 3 more real chars...
-		{
-			// put std in the next 3 chars in finalresult
-			std >>= 6;
-			int tmp = std;
-			tmp >>= 16;
-			tmp &= 0xFF;
-			*(result++) = static_cast<unsigned char>(tmp);
-			tmp = std;
-			tmp >>= 8;
-			tmp &= 0xFF;
-			*(result++) = static_cast<unsigned char>(tmp);
-			tmp = std;
-			tmp &= 0xFF;
-			*(result++) = static_cast<unsigned char>(tmp);
-			std = 0; // empty std
-			outBytes += 3;
-		}
-		++count;
+
+ARB_TARGET_SSE41 size_t DecodeBlocksSSE41(char const* in, size_t len, unsigned char* out)
+{
+	// Validation: a character is valid when (lut_lo[lo nibble] & lut_hi[hi nibble]) == 0.
+	__m128i const lut_lo
+		= _mm_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+	__m128i const lut_hi
+		= _mm_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+	// Offset from character to value, by hi nibble ('/' is special)
+	__m128i const lut_roll = _mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+	__m128i const mask_2F = _mm_set1_epi8(0x2F);
+
+	size_t used = 0;
+	for (; used + 16 <= len; used += 16, out += 12)
+	{
+		__m128i str = _mm_loadu_si128(reinterpret_cast<__m128i const*>(in + used));
+		__m128i hi_nibbles = _mm_and_si128(_mm_srli_epi32(str, 4), mask_2F);
+		__m128i lo_nibbles = _mm_and_si128(str, mask_2F);
+		__m128i hi = _mm_shuffle_epi8(lut_hi, hi_nibbles);
+		__m128i lo = _mm_shuffle_epi8(lut_lo, lo_nibbles);
+		if (!_mm_testz_si128(lo, hi))
+			break;
+		__m128i eq_2F = _mm_cmpeq_epi8(str, mask_2F);
+		__m128i roll = _mm_shuffle_epi8(lut_roll, _mm_add_epi8(eq_2F, hi_nibbles));
+		str = _mm_add_epi8(str, roll);
+		// Pack 4x6 bits into 3 bytes.
+		str = _mm_maddubs_epi16(str, _mm_set1_epi32(0x01400140));
+		str = _mm_madd_epi16(str, _mm_set1_epi32(0x00011000));
+		str = _mm_shuffle_epi8(str, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+		_mm_storel_epi64(reinterpret_cast<__m128i*>(out), str);
+		int32_t last = _mm_extract_epi32(str, 2);
+		memcpy(out + 8, &last, sizeof(last));
 	}
+	return used;
+}
+
+
+ARB_TARGET_AVX2 size_t EncodeBlocksAVX2(unsigned char const* in, size_t len, size_t readable, char* out)
+{
+	__m256i const shuffle
+		= _mm256_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1, 10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1);
+	__m256i const lut = _mm256_setr_epi8(
+		65, 71, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -19, -16, 0, 0,
+		65, 71, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -19, -16, 0, 0);
 
-	// find and decode the remaining chars, if any...
-	--count;
-	if (count % 4 != 0)
+	size_t used = 0;
+	for (; used + 24 <= len && used + 28 <= readable; used += 24, out += 32)
 	{
-		// pad out the buffer
-		for (size_t i = 0; i < 4 - (count % 4); ++i)
-			std <<= 6;
-		size_t nBits = (count % 4) * 6;
-		outBytes += nBits / 8;
-		std >>= 6;
-		int tmp = std;
-		tmp >>= 16;
-		tmp &= 0xFF;
-		*(result++) = static_cast<unsigned char>(tmp);
-		tmp = std;
-		tmp >>= 8;
-		tmp &= 0xFF;
-		*(result++) = static_cast<unsigned char>(tmp);
-		tmp = std;
-		tmp &= 0xFF;
-		*(result++) = static_cast<unsigned char>(tmp);
+		// 12 bytes in each lane.
+		__m256i str = _mm256_inserti128_si256(
+			_mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<__m128i const*>(in + used))),
+			_mm_loadu_si128(reinterpret_cast<__m128i const*>(in + used + 12)),
+			1);
+		str = _mm256_shuffle_epi8(str, shuffle);
+		__m256i t0 = _mm256_and_si256(str, _mm256_set1_epi32(0x0FC0FC00));
+		__m256i t1 = _mm256_mulhi_epu16(t0, _mm256_set1_epi32(0x04000040));
+		__m256i t2 = _mm256_and_si256(str, _mm256_set1_epi32(0x003F03F0));
+		__m256i t3 = _mm256_mullo_epi16(t2, _mm256_set1_epi32(0x01000010));
+		str = _mm256_or_si256(t1, t3);
+		__m256i indices = _mm256_subs_epu8(str, _mm256_set1_epi8(51));
+		__m256i mask = _mm256_cmpgt_epi8(str, _mm256_set1_epi8(25));
+		indices = _mm256_sub_epi8(indices, mask);
+		str = _mm256_add_epi8(str, _mm256_shuffle_epi8(lut, indices));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(out), str);
 	}
+	return used;
+}
 
-	if (outBytes < outBinData.size())
-		outBinData.resize(outBytes);
-	return true;
+
+ARB_TARGET_AVX2 size_t DecodeBlocksAVX2(char const* in, size_t len, unsigned char* out)
+{
+	__m256i const lut_lo = _mm256_setr_epi8(
+		0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A,
+		0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+	__m256i const lut_hi = _mm256_setr_epi8(
+		0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+		0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+	__m256i const lut_roll = _mm256_setr_epi8(
+		0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0,
+		0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+	__m256i const pack = _mm256_setr_epi8(
+		2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+		2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+	__m256i const mask_2F = _mm256_set1_epi8(0x2F);
+
+	size_t used = 0;
+	for (; used + 32 <= len; used += 32, out += 24)
+	{
+		__m256i str = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(in + used));
+		__m256i hi_nibbles = _mm256_and_si256(_mm256_srli_epi32(str, 4), mask_2F);
+		__m256i lo_nibbles = _mm256_and_si256(str, mask_2F);
+		__m256i hi = _mm256_shuffle_epi8(lut_hi, hi_nibbles);
+		__m256i lo = _mm256_shuffle_epi8(lut_lo, lo_nibbles);
+		if (!_mm256_testz_si256(lo, hi))
+			break;
+		__m256i eq_2F = _mm256_cmpeq_epi8(str, mask_2F);
+		__m256i roll = _mm256_shuffle_epi8(lut_roll, _mm256_add_epi8(eq_2F, hi_nibbles));
+		str = _mm256_add_epi8(str, roll);
+		str = _mm256_maddubs_epi16(str, _mm256_set1_epi32(0x01400140));
+		str = _mm256_madd_epi16(str, _mm256_set1_epi32(0x00011000));
+		str = _mm256_shuffle_epi8(str, pack);
+		// 12 bytes in each lane: move them together.
+		str = _mm256_permutevar8x32_epi32(str, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm256_castsi256_si128(str));
+		_mm_storel_epi64(reinterpret_cast<__m128i*>(out + 16), _mm256_extracti128_si256(str, 1));
+	}
+	return used;
 }
 
+#endif // ARB_BASE64_X86
 
-bool Encode(std::vector<unsigned char> const& inBinData, std::string& outData)
+
+constexpr Base64Kernel ScalarKernel = {nullptr, nullptr, 16};
+#if ARB_BASE64_X86
+constexpr Base64Kernel SSE41Kernel = {EncodeBlocksSSE41, DecodeBlocksSSE41, 16};
+constexpr Base64Kernel AVX2Kernel = {EncodeBlocksAVX2, DecodeBlocksAVX2, 32};
+#endif
+
+
+bool IsSupported(ARBBase64Kernel kernel)
 {
-	outData.clear();
-	if (inBinData.empty())
+	switch (kernel)
+	{
+	case ARBBase64Kernel::Scalar:
+		return true;
+#if ARB_BASE64_X86
+	case ARBBase64Kernel::SSE41:
+	{
+		static bool const bSupported = CpuHasSSE41();
+		return bSupported;
+	}
+	case ARBBase64Kernel::AVX2:
+	{
+		static bool const bSupported = CpuHasAVX2();
+		return bSupported;
+	}
+#endif
+	default:
 		return false;
-	size_t alsize = (inBinData.size() * 4) / 3;
-	auto encoded = std::vector<unsigned char>(alsize + ((alsize / 76) * 2) + 10);
-	size_t count = 0;
-	size_t LineLen = 0;
-	size_t nData = 0;
-	unsigned char const* s = inBinData.data();
-	int tmp = 0;
-	// let's step through the buffer and encode it...
-	if (inBinData.size() > 2) // A really small buffer causes problems with the logic below
+	}
+}
+
+
+Base64Kernel const& GetKernel(ARBBase64Kernel kernel)
+{
+#if ARB_BASE64_X86
+	if (IsSupported(kernel))
 	{
-		while (count <= inBinData.size())
+		switch (kernel)
 		{
-			if (count % 3 == 0 && count != 0)
-			{
-				tmp >>= 8;
-				tmp &= 0xFFFFFF;
-				// we have 4 new b64 chars, add them to encoded
-				int mid = tmp;
-				mid >>= 18;
-				mid &= 0x3F;
-				encoded[nData++] = base64chars[mid];
-				++LineLen;
-				mid = tmp;
-				mid >>= 12;
-				mid &= 0x3F;
-				encoded[nData++] = base64chars[mid];
-				++LineLen;
-				mid = tmp;
-				mid >>= 6;
-				mid &= 0x3F;
-				encoded[nData++] = base64chars[mid];
-				++LineLen;
-				mid = tmp;
-				mid &= 0x3F;
-				encoded[nData++] = base64chars[mid];
-				++LineLen;
-				// reset tmp
-				tmp = 0;
-				// Should we break the line?
-				if (LineLen >= MaxLineLength)
-				{
-					encoded[nData++] = '\n';
-					LineLen = 0;
-				}
-				if (inBinData.size() - count < 3)
-					break;
-			}
-			unsigned char mid = (256 - (0 - *s)) & 0xff;
-			tmp |= mid;
-			tmp <<= 8;
-			++count;
-			++s;
+		case ARBBase64Kernel::Scalar:
+			break;
+		case ARBBase64Kernel::SSE41:
+			return SSE41Kernel;
+		case ARBBase64Kernel::AVX2:
+			return AVX2Kernel;
 		}
 	}
-	// do we have some chars left...
-	size_t rest = (inBinData.size() - count) % 3;
-	if (rest != 0)
+#endif
+	return ScalarKernel;
+}
+
+
+Base64Kernel const& GetBestKernel()
+{
+	static Base64Kernel const& kernel = IsSupported(ARBBase64Kernel::AVX2)
+		? GetKernel(ARBBase64Kernel::AVX2)
+		: GetKernel(ARBBase64Kernel::SSE41);
+	return kernel;
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Encode full 3 byte groups, adding line breaks.
+ * @param kernel Encoding kernel.
+ * @param in Data to encode.
+ * @param len Number of bytes to encode, a multiple of 3.
+ * @param readable Number of bytes at 'in' that may be read.
+ * @param out Output, must have room for the encoded data.
+ * @param ioLineLen Length of the current line (carried across calls).
+ * @return End of the output.
+ */
+char* EncodeGroups(
+	Base64Kernel const& kernel,
+	unsigned char const* in,
+	size_t len,
+	size_t readable,
+	char* out,
+	size_t& ioLineLen)
+{
+	while (0 < len)
 	{
-		tmp = 0;
-		for (size_t i = 0; i < 3; ++i)
-		{
-			if (i < rest)
-			{
-				unsigned char mid = (256 - (0 - *s)) & 0xff;
-				tmp |= mid;
-				tmp <<= 8;
-				++count;
-				++s;
-			}
-			else
-			{
-				tmp |= 0;
-				tmp <<= 8;
-			}
-		}
-		tmp >>= 8;
-		tmp &= 0xFFFFFF;
-		// we have some new b64 chars, add them to encoded
-		int mid = tmp;
-		if (rest >= 1)
+		size_t lineBytes = std::min(len, (MaxLineLength - ioLineLen) / 4 * 3);
+		size_t used = 0;
+		if (kernel.encode)
 		{
-			mid >>= 18;
-			mid &= 0x3F;
-			encoded[nData++] = base64chars[mid];
-			mid = tmp;
-			mid >>= 12;
-			mid &= 0x3F;
-			encoded[nData++] = base64chars[mid];
+			used = kernel.encode(in, lineBytes, readable, out);
+			out += used / 3 * 4;
 		}
-		if (rest >= 2)
+		for (; used < lineBytes; used += 3, out += 4)
+			EncodeGroup(in + used, out);
+		in += lineBytes;
+		len -= lineBytes;
+		readable -= lineBytes;
+		ioLineLen += lineBytes / 3 * 4;
+		if (ioLineLen >= MaxLineLength)
 		{
-			mid = tmp;
-			mid >>= 6;
-			mid &= 0x3F;
-			encoded[nData++] = base64chars[mid];
+			*out++ = '\n';
+			ioLineLen = 0;
 		}
-		if (rest >= 3)
+	}
+	return out;
+}
+
+
+/**
+ * Encode the last 1 or 2 bytes, with padding.
+ */
+char* EncodeTail(unsigned char const* in, size_t len, char* out)
+{
+	if (0 == len)
+		return out;
+	unsigned char group[3] = {in[0], 1 < len ? in[1] : static_cast<unsigned char>(0), 0};
+	EncodeGroup(group, out);
+	out[3] = '=';
+	if (1 == len)
+		out[2] = '=';
+	return out + 4;
+}
+
+
+enum class DecodeStatus
+{
+	More,  ///< All input consumed
+	Done,  ///< Found '='
+	Error, ///< Invalid character
+};
+
+/**
+ * Decode characters.
+ * @param kernel Decoding kernel.
+ * @param ioIn Input, advanced past the consumed characters.
+ * @param end End of input.
+ * @param ioOut Output, advanced past the decoded bytes.
+ *              Must have room for 3/4 of the input.
+ * @param ioAccum Bits of a partial quantum (carried across calls).
+ * @param ioCount Number of characters in ioAccum (carried across calls).
+ */
+DecodeStatus DecodeChars(
+	Base64Kernel const& kernel,
+	char const*& ioIn,
+	char const* end,
+	unsigned char*& ioOut,
+	uint32_t& ioAccum,
+	unsigned int& ioCount)
+{
+	char const* in = ioIn;
+	unsigned char* out = ioOut;
+	auto rc = DecodeStatus::More;
+	while (DecodeStatus::More == rc && in < end)
+	{
+		if (kernel.decode && 0 == ioCount)
 		{
-			mid = tmp;
-			mid &= 0x3F;
-			encoded[nData++] = base64chars[mid];
+			size_t used = kernel.decode(in, static_cast<size_t>(end - in), out);
+			in += used;
+			out += used / 4 * 3;
+			if (in == end)
+				break;
 		}
-		for (size_t c = 3; c > rest; --c)
+		// The kernel hit something it can't handle (or there is no kernel).
+		// Go one character at a time until past a line break (or a block)
+		// and at the start of a quantum, then give the kernel another try.
+		char const* stop = std::min(end, in + kernel.decodeBlock);
+		bool bSkipped = false;
+		do
 		{
-			encoded[nData++] = '=';
-		}
+			unsigned char value = base64map[static_cast<unsigned char>(*in)];
+			if (value < 64)
+			{
+				ioAccum = (ioAccum << 6) | value;
+				if (4 == ++ioCount)
+				{
+					out[0] = static_cast<unsigned char>(ioAccum >> 16);
+					out[1] = static_cast<unsigned char>(ioAccum >> 8);
+					out[2] = static_cast<unsigned char>(ioAccum);
+					out += 3;
+					ioAccum = 0;
+					ioCount = 0;
+				}
+			}
+			else if (PAD == value)
+			{
+				rc = DecodeStatus::Done;
+				break;
+			}
+			else if (BAD == value)
+			{
+				rc = DecodeStatus::Error;
+				break;
+			}
+			else
+			{
+				bSkipped = true;
+			}
+			++in;
+		} while (in < end && (0 != ioCount || (!bSkipped && in < stop)));
+	}
+	ioIn = in;
+	ioOut = out;
+	return rc;
+}
+
+
+/**
+ * Write any bytes left in a partial quantum.
+ */
+unsigned char* DecodeTail(uint32_t accum, unsigned int count, unsigned char* out)
+{
+	// 1 character (6 bits) isn't enough for a byte.
+	if (2 == count)
+	{
+		*out++ = static_cast<unsigned char>(accum >> 4);
+	}
+	else if (3 == count)
+	{
+		*out++ = static_cast<unsigned char>(accum >> 10);
+		*out++ = static_cast<unsigned char>(accum >> 2);
+	}
+	return out;
+}
+
+
+bool DecodeImpl(Base64Kernel const& kernel, std::string_view inBase64, std::vector<unsigned char>& outBinData)
+{
+	outBinData.clear();
+	if (inBase64.empty())
+		return false;
+
+	outBinData.resize(inBase64.length() / 4 * 3 + 3);
+	char const* in = inBase64.data();
+	unsigned char* out = outBinData.data();
+	uint32_t accum = 0;
+	unsigned int count = 0;
+	if (DecodeStatus::Error == DecodeChars(kernel, in, in + inBase64.length(), out, accum, count))
+	{
+		outBinData.clear();
+		return false;
+	}
+	out = DecodeTail(accum, count, out);
+	outBinData.resize(static_cast<size_t>(out - outBinData.data()));
+	return true;
+}
+
+
+bool EncodeImpl(Base64Kernel const& kernel, std::vector<unsigned char> const& inBinData, std::string& outData)
+{
+	outData.clear();
+	if (inBinData.empty())
+		return false;
+
+	size_t groupBytes = inBinData.size() / 3 * 3;
+	size_t groupChars = groupBytes / 3 * 4;
+	outData.resize(groupChars + groupChars / MaxLineLength + (groupBytes < inBinData.size() ? 4 : 0));
+	char* out = &outData[0];
+	size_t lineLen = 0;
+	out = EncodeGroups(kernel, inBinData.data(), groupBytes, inBinData.size(), out, lineLen);
+	out = EncodeTail(inBinData.data() + groupBytes, inBinData.size() - groupBytes, out);
+	assert(out == outData.data() + outData.size());
+	return true;
+}
+} // namespace
+
+
+namespace dconSoft
+{
+namespace ARBCommon
+{
+namespace ARBBase64
+{
+
+bool IsKernelSupported(ARBBase64Kernel kernel)
+{
+	return IsSupported(kernel);
+}
+
+
+bool Decode(std::string_view inBase64, std::vector<unsigned char>& outBinData)
+{
+	return DecodeImpl(GetBestKernel(), inBase64, outBinData);
+}
+
+
+bool Decode(std::string_view inBase64, std::vector<unsigned char>& outBinData, ARBBase64Kernel kernel)
+{
+	return DecodeImpl(GetKernel(kernel), inBase64, outBinData);
+}
+
+
+bool Encode(std::vector<unsigned char> const& inBinData, std::string& outData)
+{
+	return EncodeImpl(GetBestKernel(), inBinData, outData);
+}
+
+
+bool Encode(std::vector<unsigned char> const& inBinData, std::string& outData, ARBBase64Kernel kernel)
+{
+	return EncodeImpl(GetKernel(kernel), inBinData, outData);
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+
+CEncoder::CEncoder(ARBBase64Sink sink)
+	: m_sink(std::move(sink))
+	// Room for a carried group, a chunk and its line breaks.
+	, m_buffer(4 + EncodeChunkBytes / 3 * 4 + EncodeChunkBytes / MaxLineBytes + 1)
+	, m_carry()
+	, m_carryLen(0)
+	, m_lineLen(0)
+	, m_bData(false)
+	, m_bOk(true)
+{
+}
+
+
+CEncoder::CEncoder(std::ostream& output)
+	: CEncoder([&output](void const* data, size_t len) {
+		output.write(static_cast<char const*>(data), static_cast<std::streamsize>(len));
+		return output.good();
+	})
+{
+}
+
+
+bool CEncoder::Write(void const* inData, size_t inLen)
+{
+	if (!m_bOk)
+		return false;
+	if (0 == inLen)
+		return true;
+	m_bData = true;
+
+	Base64Kernel const& kernel = GetBestKernel();
+	auto in = static_cast<unsigned char const*>(inData);
+	char* out = m_buffer.data();
+	if (0 < m_carryLen)
+	{
+		size_t len = std::min(inLen, sizeof(m_carry) - m_carryLen);
+		memcpy(m_carry + m_carryLen, in, len);
+		m_carryLen += len;
+		in += len;
+		inLen -= len;
+		if (m_carryLen < sizeof(m_carry))
+			return true;
+		out = EncodeGroups(kernel, m_carry, sizeof(m_carry), sizeof(m_carry), out, m_lineLen);
+		m_carryLen = 0;
 	}
-	encoded[nData] = 0;
-	bool bOk = false;
-	if (0 < nData)
+	while (sizeof(m_carry) <= inLen)
+	{
+		size_t len = std::min(inLen / 3 * 3, EncodeChunkBytes);
+		out = EncodeGroups(kernel, in, len, inLen, out, m_lineLen);
+		in += len;
+		inLen -= len;
+		if (!Flush(out))
+			return false;
+		out = m_buffer.data();
+	}
+	memcpy(m_carry, in, inLen);
+	m_carryLen = inLen;
+	return Flush(out);
+}
+
+
+bool CEncoder::Finish()
+{
+	if (!m_bOk)
+		return false;
+	char* out = EncodeTail(m_carry, m_carryLen, m_buffer.data());
+	m_carryLen = 0;
+	return Flush(out) && m_bData;
+}
+
+
+bool CEncoder::Flush(char const* end)
+{
+	if (m_buffer.data() < end)
+		m_bOk = m_sink(m_buffer.data(), static_cast<size_t>(end - m_buffer.data()));
+	return m_bOk;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+CDecoder::CDecoder(ARBBase64Sink sink)
+	: m_sink(std::move(sink))
+	, m_buffer(DecodeChunkChars / 4 * 3 + 3)
+	, m_accum(0)
+	, m_count(0)
+	, m_bData(false)
+	, m_bDone(false)
+	, m_bOk(true)
+{
+}
+
+
+CDecoder::CDecoder(std::ostream& output)
+	: CDecoder([&output](void const* data, size_t len) {
+		output.write(static_cast<char const*>(data), static_cast<std::streamsize>(len));
+		return output.good();
+	})
+{
+}
+
+
+bool CDecoder::Write(char const* inData, size_t inLen)
+{
+	if (!m_bOk)
+		return false;
+	if (0 == inLen)
+		return true;
+	m_bData = true;
+
+	Base64Kernel const& kernel = GetBestKernel();
+	while (!m_bDone && 0 < inLen)
 	{
-		bOk = true;
-		outData = std::string(encoded.begin(), encoded.begin() + nData);
+		size_t len = std::min(inLen, DecodeChunkChars);
+		char const* in = inData;
+		unsigned char* out = m_buffer.data();
+		switch (DecodeChars(kernel, in, inData + len, out, m_accum, m_count))
+		{
+		case DecodeStatus::More:
+			break;
+		case DecodeStatus::Done:
+			m_bDone = true;
+			break;
+		case DecodeStatus::Error:
+			m_bOk = false;
+			return false;
+		}
+		if (m_buffer.data() < out)
+			m_bOk = m_sink(m_buffer.data(), static_cast<size_t>(out - m_buffer.data()));
+		if (!m_bOk)
+			return false;
+		inData += len;
+		inLen -= len;
 	}
-	return bOk;
+	return true;
+}
+
+
+bool CDecoder::Finish()
+{
+	if (!m_bOk)
+		return false;
+	unsigned char* out = DecodeTail(m_accum, m_count, m_buffer.data());
+	m_accum = 0;
+	m_count = 0;
+	if (m_buffer.data() < out)
+		m_bOk = m_sink(m_buffer.data(), static_cast<size_t>(out - m_buffer.data()));
+	return m_bOk && m_bData;
 }
 
 } // namespace ARBBase64
@@ -10,6 +10,11 @@
  * @author David Connet
  *
  * Revision History
+ * 2026-10-19 Moved the calendar math to ARBDate.h (constexpr).
+ * 2026-10-19 Use a thread safe localtime, cache today's julian day.
+ * 2026-10-19 Added batch julian day conversions and CountByPeriod.
+ * 2026-10-19 Format numeric dates directly, cache locale names/pattern.
+ * 2026-10-19 Replaced ParseFields with a single pass, allocation-free parser.
  * 2012-10-26 Changed ARBDate::GetTime to avoid time_t when possible.
  * 2012-04-10 Based on wx-group thread, use std::string for internal use
  * 2011-12-30 Added eVerbose to GetString.
@@ -28,8 +33,14 @@
 #include "stdafx.h"
 #include "ARBCommon/ARBDate.h"
 
-#include "ARBCommon/StringUtil.h"
+#include <algorithm>
+#include <atomic>
+#include <clocale>
+#include <cstdint>
+#include <memory>
+#include <mutex>
 #include <time.h>
+#include <vector>
 
 #if defined(__WXWINDOWS__)
 #include <wx/datetime.h>
@@ -40,28 +51,6 @@
 #include <wx/msw/msvcrt.h>
 #endif
 
-/////////////////////////////////////////////////////////////////////////////
-// The following public domain code was found on the internet (calendar-1.11)
-// SDN stands for serial day number. The author notes it is called this to
-// differentiate the julian day (SDN) from a Julian calendar date.
-// It has been modified only slightly.
-
-// SdnToGregorian and GregorianToSdn
-/* $selId: gregor.c,v 2.0 1995/10/24 01:13:06 lees Exp $
- * Copyright 1993-1995, Scott E. Lee, all rights reserved.
- * Permission granted to use, copy, modify, distribute and sell so long as
- * the above copyright and this permission statement are retained in all
- * copies.  THERE IS NO WARRANTY - USE AT YOUR OWN RISK.
- */
-
-// VALID RANGE
-//     4714 B.C. to at least 10000 A.D.
-// REFERENCES
-//     Conversions Between Calendar Date and Julian Day Number by Robert J.
-//     Tantzen, Communications of the Association for Computing Machinery
-//     August 1963.  (Also published in Collected Algorithms from CACM,
-//     algorithm number 199).
-
 namespace dconSoft
 {
 namespace ARBCommon
@@ -69,117 +58,620 @@ namespace ARBCommon
 namespace
 {
 
-constexpr long SDN_OFFSET = 32045;
-constexpr long DAYS_PER_5_MONTHS = 153;
-constexpr long DAYS_PER_4_YEARS = 1461;
-constexpr long DAYS_PER_400_YEARS = 146097;
+// SdnToGregorian without branches, in 32bit unsigned math so loops using
+// it vectorize. Returns 0 for invalid days.
+// (Same constants as ARBDate::SdnToGregorian.)
+constexpr uint32_t BATCH_SDN_OFFSET = 32045;
+constexpr uint32_t BATCH_DAYS_PER_5_MONTHS = 153;
+constexpr uint32_t BATCH_DAYS_PER_4_YEARS = 1461;
+constexpr uint32_t BATCH_DAYS_PER_400_YEARS = 146097;
 
-void SdnToGregorian(long int sdn, int* pYear, int* pMonth, int* pDay)
+inline uint32_t IsBatchValid(long sdn)
 {
-	if (sdn <= 0)
-	{
-		*pYear = 0;
-		*pMonth = 0;
-		*pDay = 0;
-		return;
-	}
+	// Only 32bit compares: SSE2 has no 64bit compare.
+	uint32_t valid = static_cast<uint32_t>(sdn) - 1 < static_cast<uint32_t>(ARBDate::MaxBatchJulian) ? 1u : 0u;
+	if constexpr (sizeof(long) > sizeof(uint32_t))
+		valid &= 0 == static_cast<uint32_t>(static_cast<uint64_t>(sdn) >> 32) ? 1u : 0u;
+	return valid;
+}
 
-	long int temp = (sdn + SDN_OFFSET) * 4 - 1;
 
-	/* Calculate the century (year/100). */
-	long int century = temp / DAYS_PER_400_YEARS;
+inline void SdnToGregorianBatch(long sdn, int32_t& outYear, int32_t& outMonth, int32_t& outDay)
+{
+	uint32_t const valid = IsBatchValid(sdn);
+	uint32_t const mask = 0u - valid;
+	uint32_t temp = ((static_cast<uint32_t>(sdn) & mask) + BATCH_SDN_OFFSET) * 4 - 1;
 
-	/* Calculate the year and day of year (1 <= dayOfYear <= 366). */
-	temp = ((temp % DAYS_PER_400_YEARS) / 4) * 4 + 3;
-	long int year = (century * 100) + (temp / DAYS_PER_4_YEARS);
-	long int dayOfYear = (temp % DAYS_PER_4_YEARS) / 4 + 1;
+	uint32_t const century = temp / BATCH_DAYS_PER_400_YEARS;
+	temp = ((temp % BATCH_DAYS_PER_400_YEARS) / 4) * 4 + 3;
+	int32_t year = static_cast<int32_t>(century * 100 + temp / BATCH_DAYS_PER_4_YEARS);
+	uint32_t const dayOfYear = (temp % BATCH_DAYS_PER_4_YEARS) / 4 + 1;
 
-	/* Calculate the month and day of month. */
 	temp = dayOfYear * 5 - 3;
-	long int month = temp / DAYS_PER_5_MONTHS;
-	long int day = (temp % DAYS_PER_5_MONTHS) / 5 + 1;
+	int32_t month = static_cast<int32_t>(temp / BATCH_DAYS_PER_5_MONTHS);
+	int32_t const day = static_cast<int32_t>((temp % BATCH_DAYS_PER_5_MONTHS) / 5 + 1);
+
+	// Months are counted from March: Jan/Feb are in the next year.
+	int32_t const nextYear = month >= 10 ? 1 : 0;
+	month += 3 - 12 * nextYear;
+	year += nextYear - 4800;
+	year -= year <= 0 ? 1 : 0;
+
+	outYear = year & static_cast<int32_t>(mask);
+	outMonth = month & static_cast<int32_t>(mask);
+	outDay = day & static_cast<int32_t>(mask);
+}
 
-	/* Convert to the normal beginning of the year. */
-	if (month < 10)
-		month += 3;
-	else
+
+// GregorianToSdn(inYear, 1, 1)
+// (year / 100) * 146097 fits in int32_t up to MaxBatchJulian.
+inline int32_t FirstDayOfYear(int32_t inYear)
+{
+	// Jan is month 10 of the previous year, counting from March.
+	int32_t const year = inYear + 4800 + (inYear < 0 ? 1 : 0) - 1;
+	return ((year / 100) * static_cast<int32_t>(BATCH_DAYS_PER_400_YEARS)) / 4
+		   + ((year % 100) * static_cast<int32_t>(BATCH_DAYS_PER_4_YEARS)) / 4
+		   + static_cast<int32_t>((10 * BATCH_DAYS_PER_5_MONTHS + 2) / 5 + 1 - BATCH_SDN_OFFSET);
+}
+
+
+inline int32_t DayOfWeekBatch(long sdn, int32_t inFirstDay)
+{
+	uint32_t const mask = 0u - IsBatchValid(sdn);
+	uint32_t const day = static_cast<uint32_t>(sdn) & mask;
+	return static_cast<int32_t>(((day + 1) % 7 + (7 - inFirstDay)) % 7 & mask);
+}
+
+
+// Maps dates to period numbers, where numbers increase with the date.
+// Invalid dates get UINT32_MAX.
+template <ARBDatePeriod Period>
+void GetPeriodKeys(long const* inJulian, size_t inCount, int32_t inFirstDay, uint32_t* outKeys)
+{
+	for (size_t i = 0; i < inCount; ++i)
 	{
-		year += 1;
-		month -= 9;
+		uint32_t key;
+		if constexpr (ARBDatePeriod::Week == Period)
+		{
+			// Weeks start on days where (day + 1) % 7 == inFirstDay.
+			uint32_t const dayOfWeek = static_cast<uint32_t>(DayOfWeekBatch(inJulian[i], inFirstDay));
+			key = (static_cast<uint32_t>(inJulian[i]) + 7 - dayOfWeek) / 7;
+		}
+		else
+		{
+			int32_t yr, mon, day;
+			SdnToGregorianBatch(inJulian[i], yr, mon, day);
+			// Years start at -4714 (there is no year 0).
+			key = static_cast<uint32_t>(yr + 4800);
+			if constexpr (ARBDatePeriod::Month == Period)
+				key = key * 12 + static_cast<uint32_t>(mon - 1);
+		}
+		outKeys[i] = key | (0u - (1u - IsBatchValid(inJulian[i])));
 	}
+}
 
-	/* Adjust to the B.C./A.D. type numbering. */
-	year -= 4800;
-	if (year <= 0)
-		year--;
 
-	*pYear = year;
-	*pMonth = month;
-	*pDay = day;
+ARBDate PeriodStart(uint32_t inKey, ARBDatePeriod inPeriod, int32_t inFirstDay)
+{
+	ARBDate date;
+	switch (inPeriod)
+	{
+	case ARBDatePeriod::Week:
+		date.SetJulianDay(static_cast<long>(inKey) * 7 - 7 + (inFirstDay + 6) % 7);
+		break;
+	case ARBDatePeriod::Month:
+		date.SetDate(static_cast<int>(inKey / 12) - 4800, static_cast<int>(inKey % 12) + 1, 1);
+		break;
+	case ARBDatePeriod::Year:
+		date.SetDate(static_cast<int>(inKey) - 4800, 1, 1);
+		break;
+	}
+	return date;
+}
+
+
+// Thread safe localtime.
+bool LocalTime(time_t inTime, struct tm& outTime)
+{
+#if defined(ARB_HAS_SECURE_LOCALTIME)
+	return 0 == _localtime64_s(&outTime, &inTime);
+#elif defined(ARB_HAS_LOCALTIME_R)
+	return nullptr != localtime_r(&inTime, &outTime);
+#else
+	struct tm* pTime = localtime(&inTime);
+	if (pTime)
+		outTime = *pTime;
+	return nullptr != pTime;
+#endif
 }
 
 
-long int GregorianToSdn(int inputYear, int inputMonth, int inputDay)
+long LocalTimeToSdn(time_t inTime)
 {
-	int year = 0;
-	int month = 0;
+	struct tm tim;
+	if (!LocalTime(inTime, tim))
+		return 0;
+	return ARBDate::GregorianToSdn(tim.tm_year + 1900, tim.tm_mon + 1, tim.tm_mday);
+}
 
-	/* check for invalid dates */
-	if (inputYear == 0 || inputYear < -4714 || inputMonth <= 0 || inputMonth > 12 || inputDay <= 0 || inputDay > 31)
+
+// Julian day of the current date, valid from local midnight to the next
+// (found with mktime, so DST changes are handled). Readers don't lock: the
+// sequence number is odd while an update is in progress and changes with
+// each update, so a reader that sees it change just computes the date.
+class TodayCache
+{
+public:
+	bool Lookup(time_t inTime, long& outJulian) const
 	{
-		return 0;
+		unsigned int seq = m_seq.load();
+		if (seq & 1)
+			return false;
+		time_t start = m_start.load();
+		time_t end = m_end.load();
+		long julian = m_julian.load();
+		if (seq != m_seq.load() || inTime < start || end <= inTime)
+			return false;
+		outJulian = julian;
+		return true;
 	}
 
-	/* check for dates before SDN 1 (Nov 25, 4714 B.C.) */
-	if (inputYear == -4714)
+	long Update(time_t inNow)
 	{
-		if (inputMonth < 11)
-			return 0;
-		if (inputMonth == 11 && inputDay < 25)
+		struct tm tim;
+		if (!LocalTime(inNow, tim))
 			return 0;
+		long julian = ARBDate::GregorianToSdn(tim.tm_year + 1900, tim.tm_mon + 1, tim.tm_mday);
+		tim.tm_sec = 0;
+		tim.tm_min = 0;
+		tim.tm_hour = 0;
+		tim.tm_isdst = -1;
+		time_t start = mktime(&tim);
+		tim.tm_mday += 1;
+		tim.tm_sec = 0;
+		tim.tm_min = 0;
+		tim.tm_hour = 0;
+		tim.tm_isdst = -1;
+		time_t end = mktime(&tim);
+		if (static_cast<time_t>(-1) != start && static_cast<time_t>(-1) != end && start <= inNow && inNow < end)
+		{
+			std::lock_guard<std::mutex> lock(m_lock);
+			++m_seq;
+			m_start = start;
+			m_end = end;
+			m_julian = julian;
+			++m_seq;
+		}
+		return julian;
 	}
 
-	/* Make year always a positive number. */
-	if (inputYear < 0)
-		year = inputYear + 4801;
-	else
-		year = inputYear + 4800;
+private:
+	std::mutex m_lock; ///< Serializes updates
+	std::atomic<unsigned int> m_seq{0};
+	std::atomic<time_t> m_start{0};
+	std::atomic<time_t> m_end{0};
+	std::atomic<long> m_julian{0};
+};
 
-	/* Adjust the start of the year. */
-	if (inputMonth > 2)
-		month = inputMonth - 3;
+TodayCache s_today;
+
+
+// Order of the fields in a numeric date format.
+struct DateLayout
+{
+	wchar_t sep;
+	int idxYr;
+	int idxMon;
+	int idxDay;
+};
+
+
+bool GetLayout(ARBDateFormat inFormat, DateLayout& outLayout)
+{
+	switch (inFormat)
+	{
+	case ARBDateFormat::Locale:
+	case ARBDateFormat::YYYYMMDD:
+	case ARBDateFormat::Reserved14:
+	case ARBDateFormat::Verbose:
+		return false;
+	case ARBDateFormat::DashMMDDYYYY:
+	case ARBDateFormat::DashMDY:
+		outLayout = {L'-', 2, 0, 1};
+		return true;
+	case ARBDateFormat::SlashMMDDYYYY:
+	case ARBDateFormat::SlashMDY:
+		outLayout = {L'/', 2, 0, 1};
+		return true;
+	case ARBDateFormat::DashYYYYMMDD: // ISO
+	case ARBDateFormat::DashYMD:
+		outLayout = {L'-', 0, 1, 2};
+		return true;
+	case ARBDateFormat::SlashYYYYMMDD:
+	case ARBDateFormat::SlashYMD:
+		outLayout = {L'/', 0, 1, 2};
+		return true;
+	case ARBDateFormat::DashDDMMYYYY:
+	case ARBDateFormat::DashDMY:
+		outLayout = {L'-', 2, 1, 0};
+		return true;
+	case ARBDateFormat::SlashDDMMYYYY:
+	case ARBDateFormat::SlashDMY:
+		outLayout = {L'/', 2, 1, 0};
+		return true;
+	}
+	return false;
+}
+
+
+// Parse 3 numbers separated by the layout's separator. Like the old
+// stream based parsing, whitespace before a number and anything after it
+// (up to the separator) is ignored.
+template <typename CharT> ARBDate ParseDate(CharT const* inDate, size_t inLength, DateLayout const& inLayout)
+{
+	CharT const* p = inDate;
+	CharT const* end = inDate + inLength;
+	int vals[3];
+	for (int n = 0; n < 3; ++n)
+	{
+		while (p != end && (' ' == *p || '\t' == *p || '\r' == *p || '\n' == *p))
+			++p;
+		int val = 0;
+		for (; p != end && '0' <= *p && *p <= '9'; ++p)
+		{
+			val = val * 10 + (*p - '0');
+			if (99999 < val)
+				return ARBDate();
+		}
+		vals[n] = val;
+		if (n < 2)
+		{
+			while (p != end && static_cast<wchar_t>(*p) != inLayout.sep)
+				++p;
+			if (p == end)
+				return ARBDate();
+			++p;
+		}
+	}
+	// SetDate verifies the date round trips (rejecting "2/30/2010").
+	ARBDate date;
+	date.SetDate(vals[inLayout.idxYr], vals[inLayout.idxMon], vals[inLayout.idxDay]);
+	return date;
+}
+
+
+template <typename CharT>
+size_t ParseDates(
+	std::basic_string_view<CharT> const* inDates,
+	size_t inCount,
+	ARBDateFormat inFormat,
+	ARBDate* outDates)
+{
+	DateLayout layout;
+	if (!GetLayout(inFormat, layout))
+	{
+		for (size_t i = 0; i < inCount; ++i)
+			outDates[i] = ARBDate::Parse(inDates[i], inFormat);
+	}
 	else
 	{
-		month = inputMonth + 9;
-		year--;
+		for (size_t i = 0; i < inCount; ++i)
+			outDates[i] = ParseDate(inDates[i].data(), inDates[i].size(), layout);
+	}
+	size_t nValid = 0;
+	for (size_t i = 0; i < inCount; ++i)
+	{
+		if (outDates[i].IsValid())
+			++nValid;
+	}
+	return nValid;
+}
+
+
+// Write a number, zero padded to inWidth characters (like "%0*d").
+template <typename CharT> CharT* WriteNumber(CharT* p, int inValue, int inWidth)
+{
+	unsigned int value = static_cast<unsigned int>(inValue);
+	if (inValue < 0)
+	{
+		*p++ = '-';
+		value = 0u - value;
+		--inWidth;
+	}
+	CharT digits[10];
+	int nDigits = 0;
+	do
+	{
+		digits[nDigits++] = static_cast<CharT>('0' + value % 10);
+		value /= 10;
+	} while (0 != value);
+	for (int i = nDigits; i < inWidth; ++i)
+		*p++ = '0';
+	while (0 < nDigits)
+		*p++ = digits[--nDigits];
+	return p;
+}
+
+
+// Write 3 numbers, with a separator between them (if not 0).
+template <typename CharT>
+CharT* WriteFields(CharT* p, char inSep, int inVal1, int inWidth1, int inVal2, int inWidth2, int inVal3, int inWidth3)
+{
+	p = WriteNumber(p, inVal1, inWidth1);
+	if (inSep)
+		*p++ = inSep;
+	p = WriteNumber(p, inVal2, inWidth2);
+	if (inSep)
+		*p++ = inSep;
+	return WriteNumber(p, inVal3, inWidth3);
+}
+
+
+// Numeric formats only. Returns number of characters written.
+template <typename CharT> size_t FormatNumeric(CharT* outBuffer, ARBDateFormat inFormat, int yr, int mon, int day)
+{
+	CharT* p = outBuffer;
+	switch (inFormat)
+	{
+	case ARBDateFormat::Locale:
+	case ARBDateFormat::Verbose:
+		break;
+	case ARBDateFormat::DashMMDDYYYY:
+		p = WriteFields(p, '-', mon, 2, day, 2, yr, 4);
+		break;
+	case ARBDateFormat::YYYYMMDD:
+		p = WriteFields(p, 0, yr, 4, mon, 2, day, 2);
+		break;
+	case ARBDateFormat::Reserved14:
+	case ARBDateFormat::SlashMMDDYYYY:
+		p = WriteFields(p, '/', mon, 2, day, 2, yr, 4);
+		break;
+	case ARBDateFormat::DashYYYYMMDD:
+		p = WriteFields(p, '-', yr, 4, mon, 2, day, 2);
+		break;
+	case ARBDateFormat::SlashYYYYMMDD:
+		p = WriteFields(p, '/', yr, 4, mon, 2, day, 2);
+		break;
+	case ARBDateFormat::DashDDMMYYYY:
+		p = WriteFields(p, '-', day, 2, mon, 2, yr, 4);
+		break;
+	case ARBDateFormat::SlashDDMMYYYY:
+		p = WriteFields(p, '/', day, 2, mon, 2, yr, 4);
+		break;
+	case ARBDateFormat::DashMDY:
+		p = WriteFields(p, '-', mon, 1, day, 1, yr, 1);
+		break;
+	case ARBDateFormat::SlashMDY:
+		p = WriteFields(p, '/', mon, 1, day, 1, yr, 1);
+		break;
+	case ARBDateFormat::DashYMD:
+		p = WriteFields(p, '-', yr, 1, mon, 1, day, 1);
+		break;
+	case ARBDateFormat::SlashYMD:
+		p = WriteFields(p, '/', yr, 1, mon, 1, day, 1);
+		break;
+	case ARBDateFormat::DashDMY:
+		p = WriteFields(p, '-', day, 1, mon, 1, yr, 1);
+		break;
+	case ARBDateFormat::SlashDMY:
+		p = WriteFields(p, '/', day, 1, mon, 1, yr, 1);
+		break;
+	}
+	return static_cast<size_t>(p - outBuffer);
+}
+
+
+// Pieces of a locale's date format.
+enum class DateToken
+{
+	Literal,
+	Year,      ///< %Y
+	Year2,     ///< %y
+	Month,     ///< Unpadded month
+	Month2,    ///< %m
+	Day,       ///< Unpadded day
+	Day2,      ///< %d
+	MonthName, ///< %B
+	MonthAbbr, ///< %b
+	DayName,   ///< %A
+	DayAbbr,   ///< %a
+};
+
+struct DatePart
+{
+	DateToken token;
+	wxString text; ///< Literal text
+};
+
+
+// wxDateTime formats through strftime every time (and looks up names the
+// same way). Cache the current locale's names and its short date format.
+struct LocaleDateInfo
+{
+	std::string locale; ///< setlocale name
+	wxString months[12];
+	wxString monthsAbbr[12];
+	wxString days[7];
+	wxString daysAbbr[7];
+	std::vector<DatePart> datePattern; ///< Empty if it couldn't be determined
+};
+
+
+void AppendPattern(
+	wxString& ioString,
+	std::vector<DatePart> const& inPattern,
+	LocaleDateInfo const& inInfo,
+	int yr,
+	int mon,
+	int day,
+	int dayOfWeek)
+{
+	wchar_t buffer[16];
+	for (auto const& part : inPattern)
+	{
+		wchar_t* p = buffer;
+		switch (part.token)
+		{
+		case DateToken::Literal:
+			ioString += part.text;
+			break;
+		case DateToken::Year:
+			p = WriteNumber(p, yr, 4);
+			break;
+		case DateToken::Year2:
+			p = WriteNumber(p, (yr % 100 + 100) % 100, 2);
+			break;
+		case DateToken::Month:
+			p = WriteNumber(p, mon, 1);
+			break;
+		case DateToken::Month2:
+			p = WriteNumber(p, mon, 2);
+			break;
+		case DateToken::Day:
+			p = WriteNumber(p, day, 1);
+			break;
+		case DateToken::Day2:
+			p = WriteNumber(p, day, 2);
+			break;
+		case DateToken::MonthName:
+			ioString += inInfo.months[mon - 1];
+			break;
+		case DateToken::MonthAbbr:
+			ioString += inInfo.monthsAbbr[mon - 1];
+			break;
+		case DateToken::DayName:
+			ioString += inInfo.days[dayOfWeek];
+			break;
+		case DateToken::DayAbbr:
+			ioString += inInfo.daysAbbr[dayOfWeek];
+			break;
+		}
+		if (p != buffer)
+			ioString.append(buffer, static_cast<size_t>(p - buffer));
+	}
+}
+
+
+wxString FormatPattern(std::vector<DatePart> const& inPattern, LocaleDateInfo const& inInfo, ARBDate const& inDate)
+{
+	wxString str;
+	AppendPattern(str, inPattern, inInfo, inDate.GetYear(), inDate.GetMonth(), inDate.GetDay(), inDate.GetDayOfWeek());
+	return str;
+}
+
+
+wxString FormatLocaleDate(ARBDate const& inDate)
+{
+	int yr, mon, day;
+	inDate.GetDate(yr, mon, day);
+	return wxDateTime(static_cast<wxDateTime::wxDateTime_t>(day), static_cast<wxDateTime::Month>(mon - 1), yr)
+		.FormatDate();
+}
+
+
+// Work out the short date format by tokenizing a formatted date, then
+// verify the result matches wx on dates that show how numbers are padded.
+void InitDatePattern(LocaleDateInfo& ioInfo)
+{
+	ARBDate const probe(2033, 11, 22);
+	int const dayOfWeek = probe.GetDayOfWeek();
+	wxString const str = FormatLocaleDate(probe);
+
+	struct Match
+	{
+		wxString text;
+		DateToken token;
+	};
+	Match const matches[] = {
+		{ioInfo.months[10], DateToken::MonthName},
+		{ioInfo.monthsAbbr[10], DateToken::MonthAbbr},
+		{ioInfo.days[dayOfWeek], DateToken::DayName},
+		{ioInfo.daysAbbr[dayOfWeek], DateToken::DayAbbr},
+		{L"2033", DateToken::Year},
+		{L"33", DateToken::Year2},
+		{L"11", DateToken::Month2},
+		{L"22", DateToken::Day2},
+	};
+
+	std::vector<DatePart> pattern;
+	for (size_t pos = 0; pos < str.length();)
+	{
+		bool bMatched = false;
+		for (auto const& match : matches)
+		{
+			if (!match.text.empty() && 0 == str.compare(pos, match.text.length(), match.text))
+			{
+				pattern.push_back({match.token, wxString()});
+				pos += match.text.length();
+				bMatched = true;
+				break;
+			}
+		}
+		if (!bMatched)
+		{
+			if (pattern.empty() || DateToken::Literal != pattern.back().token)
+				pattern.push_back({DateToken::Literal, wxString()});
+			pattern.back().text += str[pos++];
+		}
 	}
 
-	return (
-		((year / 100) * DAYS_PER_400_YEARS) / 4 + ((year % 100) * DAYS_PER_4_YEARS) / 4
-		+ (month * DAYS_PER_5_MONTHS + 2) / 5 + inputDay - SDN_OFFSET);
+	ARBDate const checks[] = {ARBDate(2004, 2, 5), ARBDate(1999, 12, 31), probe};
+	for (int padding = 0; padding < 4; ++padding)
+	{
+		for (auto& part : pattern)
+		{
+			if (DateToken::Month == part.token || DateToken::Month2 == part.token)
+				part.token = (padding & 1) ? DateToken::Month : DateToken::Month2;
+			else if (DateToken::Day == part.token || DateToken::Day2 == part.token)
+				part.token = (padding & 2) ? DateToken::Day : DateToken::Day2;
+		}
+		bool bOk = true;
+		for (auto const& check : checks)
+		{
+			if (FormatPattern(pattern, ioInfo, check) != FormatLocaleDate(check))
+			{
+				bOk = false;
+				break;
+			}
+		}
+		if (bOk)
+		{
+			ioInfo.datePattern = std::move(pattern);
+			return;
+		}
+	}
 }
 
 
-int ParseFields(wxString inDate, char sep, unsigned short& val1, unsigned short& val2, unsigned short& val3)
+std::shared_ptr<LocaleDateInfo const> GetLocaleDateInfo()
 {
-	int nVals = 0;
-	wxString::size_type pos = inDate.find(sep);
-	if (wxString::npos != pos)
+	static std::mutex s_lock;
+	static std::shared_ptr<LocaleDateInfo const> s_info;
+
+	char const* locale = setlocale(LC_TIME, nullptr);
+	if (!locale)
+		locale = "";
+	std::lock_guard<std::mutex> lock(s_lock);
+	if (!s_info || s_info->locale != locale)
 	{
-		val1 = static_cast<unsigned short>(StringUtil::ToCLong(inDate));
-		++nVals;
-		inDate = inDate.substr(pos + 1);
-		pos = inDate.find(sep);
-		if (wxString::npos != pos)
+		auto info = std::make_shared<LocaleDateInfo>();
+		info->locale = locale;
+		for (int i = 0; i < 12; ++i)
 		{
-			val2 = static_cast<unsigned short>(StringUtil::ToCLong(inDate));
-			++nVals;
-			inDate = inDate.substr(pos + 1);
-			val3 = static_cast<unsigned short>(StringUtil::ToCLong(inDate));
-			++nVals;
+			auto month = static_cast<wxDateTime::Month>(i);
+			info->months[i] = wxDateTime::GetMonthName(month, wxDateTime::Name_Full);
+			info->monthsAbbr[i] = wxDateTime::GetMonthName(month, wxDateTime::Name_Abbr);
 		}
+		for (int i = 0; i < 7; ++i)
+		{
+			auto day = static_cast<wxDateTime::WeekDay>(i);
+			info->days[i] = wxDateTime::GetWeekDayName(day, wxDateTime::Name_Full);
+			info->daysAbbr[i] = wxDateTime::GetWeekDayName(day, wxDateTime::Name_Abbr);
+		}
+		InitDatePattern(*info);
+		s_info = info;
 	}
-	return nVals;
+	return s_info;
 }
 
 } // namespace
@@ -209,71 +701,54 @@ ARBDate ARBDate::FromString(wxString const& inDate, ARBDateFormat inFormat)
 		assert(0);
 #endif
 	}
-	else if (0 < inDate.length())
+	else
 	{
-		unsigned short val1 = 0, val2 = 0, val3 = 0;
-		int nDash = ParseFields(inDate, '-', val1, val2, val3);
-		int nSlash = ParseFields(inDate, '/', val1, val2, val3);
-		int yr = 0, mon = 0, day = 0;
-		if ((3 == nDash
-			 && (ARBDateFormat::DashMMDDYYYY == inFormat || ARBDateFormat::DashYYYYMMDD == inFormat
-				 || ARBDateFormat::DashDDMMYYYY == inFormat || ARBDateFormat::DashMDY == inFormat
-				 || ARBDateFormat::DashYMD == inFormat || ARBDateFormat::DashDMY == inFormat))
-			|| (3 == nSlash
-				&& (ARBDateFormat::SlashMMDDYYYY == inFormat || ARBDateFormat::SlashYYYYMMDD == inFormat
-					|| ARBDateFormat::SlashDDMMYYYY == inFormat || ARBDateFormat::SlashMDY == inFormat
-					|| ARBDateFormat::SlashYMD == inFormat || ARBDateFormat::SlashDMY == inFormat)))
-		{
-			bool bOk = true;
-			switch (inFormat)
-			{
-			case ARBDateFormat::Locale:
-			case ARBDateFormat::YYYYMMDD:
-			case ARBDateFormat::Reserved14:
-			case ARBDateFormat::Verbose:
-				assert(0);
-				bOk = false;
-				break;
-			case ARBDateFormat::DashMMDDYYYY:
-			case ARBDateFormat::DashMDY:
-			case ARBDateFormat::SlashMMDDYYYY:
-			case ARBDateFormat::SlashMDY:
-				mon = val1;
-				day = val2;
-				yr = val3;
-				break;
-			case ARBDateFormat::DashYYYYMMDD: // ISO
-			case ARBDateFormat::DashYMD:
-			case ARBDateFormat::SlashYYYYMMDD:
-			case ARBDateFormat::SlashYMD:
-				yr = val1;
-				mon = val2;
-				day = val3;
-				break;
-			case ARBDateFormat::DashDDMMYYYY:
-			case ARBDateFormat::DashDMY:
-			case ARBDateFormat::SlashDDMMYYYY:
-			case ARBDateFormat::SlashDMY:
-				day = val1;
-				mon = val2;
-				yr = val3;
-				break;
-			}
-			if (bOk)
-				date.SetDate(yr, mon, day);
-		}
-		if (date.IsValid())
-		{
-			int yr2, mon2, day2;
-			date.GetDate(yr2, mon2, day2);
-			if (yr != yr2 || mon != mon2 || day != day2)
-				date.clear();
-		}
+		DateLayout layout;
+		if (GetLayout(inFormat, layout))
+			date = ParseDate(inDate.wc_str(), inDate.length(), layout);
 	}
 	return date;
 }
 
 
+// static
+ARBDate ARBDate::Parse(std::wstring_view inDate, ARBDateFormat inFormat)
+{
+	if (ARBDateFormat::Locale == inFormat)
+		return FromString(wxString(inDate.data(), inDate.size()), inFormat);
+	DateLayout layout;
+	if (!GetLayout(inFormat, layout))
+		return ARBDate();
+	return ParseDate(inDate.data(), inDate.size(), layout);
+}
+
+
+// static
+ARBDate ARBDate::Parse(std::string_view inDate, ARBDateFormat inFormat)
+{
+	if (ARBDateFormat::Locale == inFormat)
+		return FromString(wxString::FromUTF8(inDate.data(), inDate.size()), inFormat);
+	DateLayout layout;
+	if (!GetLayout(inFormat, layout))
+		return ARBDate();
+	return ParseDate(inDate.data(), inDate.size(), layout);
+}
+
+
+// static
+size_t ARBDate::Parse(std::wstring_view const* inDates, size_t inCount, ARBDateFormat inFormat, ARBDate* outDates)
+{
+	return ParseDates(inDates, inCount, inFormat, outDates);
+}
+
+
+// static
+size_t ARBDate::Parse(std::string_view const* inDates, size_t inCount, ARBDateFormat inFormat, ARBDate* outDates)
+{
+	return ParseDates(inDates, inCount, inFormat, outDates);
+}
+
+
 // static
 wxString ARBDate::GetValidDateString(ARBDate const& inFrom, ARBDate const& inTo, ARBDateFormat inFormat)
 {
@@ -299,133 +774,71 @@ wxString ARBDate::GetValidDateString(ARBDate const& inFrom, ARBDate const& inTo,
 ARBDate::ARBDate(time_t inTime)
 	: m_Julian(0)
 {
-	if (0 != inTime)
-	{
-#if defined(ARB_HAS_SECURE_LOCALTIME)
-		struct tm l;
-		_localtime64_s(&l, &inTime);
-		struct tm* pTime = &l;
-#else
-		struct tm* pTime = localtime(&inTime);
-#endif
-		m_Julian = GregorianToSdn(pTime->tm_year + 1900, pTime->tm_mon + 1, pTime->tm_mday);
-	}
+	if (0 != inTime && !s_today.Lookup(inTime, m_Julian))
+		m_Julian = LocalTimeToSdn(inTime);
 }
 
 
 void ARBDate::SetToday()
 {
-	time_t t;
-	time(&t);
-#if defined(ARB_HAS_SECURE_LOCALTIME)
-	struct tm l;
-	_localtime64_s(&l, &t);
-	struct tm* pTime = &l;
-#else
-	struct tm* pTime = localtime(&t);
-#endif
-	m_Julian = GregorianToSdn(pTime->tm_year + 1900, pTime->tm_mon + 1, pTime->tm_mday);
+	time_t now = time(nullptr);
+	if (!s_today.Lookup(now, m_Julian))
+		m_Julian = s_today.Update(now);
 }
 
 
-bool ARBDate::SetDate(int inYr, int inMon, int inDay, bool bClearOnError)
+wxString ARBDate::GetString(ARBDateFormat inFormat, bool inForceOutput) const
 {
-	bool bOk = true;
-	long julian = GregorianToSdn(inYr, inMon, inDay);
-	int yr, mon, day;
-	SdnToGregorian(julian, &yr, &mon, &day);
-	if (yr != inYr || mon != inMon || day != inDay)
-	{
-		bOk = false;
-		if (bClearOnError)
-			m_Julian = 0;
-	}
-	else
-		m_Julian = julian;
-	return bOk;
+	wxString date;
+	AppendTo(date, inFormat, inForceOutput);
+	return date;
 }
 
 
-wxString ARBDate::GetString(ARBDateFormat inFormat, bool inForceOutput) const
+void ARBDate::AppendTo(wxString& ioString, ARBDateFormat inFormat, bool inForceOutput) const
 {
 	if (!inForceOutput && !IsValid())
-		return wxString();
-	wxString date;
-	int yr = 0;
-	int mon = 0;
-	int day = 0;
-	if (IsValid())
+		return;
+	ARBDate date(*this);
+	if (!date.IsValid())
+		date.SetToday();
+	int yr, mon, day;
+	SdnToGregorian(date.m_Julian, yr, mon, day);
+
+	if (ARBDateFormat::Locale == inFormat || ARBDateFormat::Verbose == inFormat)
 	{
-		SdnToGregorian(m_Julian, &yr, &mon, &day);
+		static const std::vector<DatePart> verbose{
+			{DateToken::DayName, wxString()},
+			{DateToken::Literal, L", "},
+			{DateToken::MonthName, wxString()},
+			{DateToken::Literal, L" "},
+			{DateToken::Day2, wxString()},
+			{DateToken::Literal, L", "},
+			{DateToken::Year, wxString()},
+		};
+		auto info = GetLocaleDateInfo();
+		if (ARBDateFormat::Verbose == inFormat)
+			AppendPattern(ioString, verbose, *info, yr, mon, day, date.GetDayOfWeek());
+		else if (!info->datePattern.empty())
+			AppendPattern(ioString, info->datePattern, *info, yr, mon, day, date.GetDayOfWeek());
+		else
+			ioString += FormatLocaleDate(date);
 	}
 	else
 	{
-		auto dt = wxDateTime::Today();
-		yr = dt.GetYear();
-		mon = static_cast<int>(dt.GetMonth()) + 1; // Because of below
-		day = static_cast<int>(dt.GetDay());
-	}
-	wxDateTime dt(static_cast<wxDateTime::wxDateTime_t>(day), static_cast<wxDateTime::Month>(mon - 1), yr);
-	switch (inFormat)
-	{
-	case ARBDateFormat::Locale:
-		date = dt.FormatDate();
-		break;
-	//%d day 01
-	//%m month 01
-	//%Y year yyyy
-	case ARBDateFormat::DashMMDDYYYY: ///< MM-DD-YYYY
-		date = dt.Format(L"%m-%d-%Y");
-		break;
-	case ARBDateFormat::YYYYMMDD:
-		date = dt.Format(L"%Y%m%d");
-		break;
-	case ARBDateFormat::Verbose:
-		date = dt.Format(L"%A, %B %d, %Y");
-		break;
-	case ARBDateFormat::Reserved14:
-	case ARBDateFormat::SlashMMDDYYYY: ///< MM/DD/YYYY
-		date = dt.Format(L"%m/%d/%Y");
-		break;
-	case ARBDateFormat::DashYYYYMMDD: ///< YYYY-MM-DD
-		date = dt.Format(L"%Y-%m-%d");
-		break;
-	case ARBDateFormat::SlashYYYYMMDD: ///< YYYY/MM/DD
-		date = dt.Format(L"%Y/%m/%d");
-		break;
-	case ARBDateFormat::DashDDMMYYYY: ///< DD-MM-YYYY
-		date = dt.Format(L"%d-%m-%Y");
-		break;
-	case ARBDateFormat::SlashDDMMYYYY: ///< DD/MM/YYYY
-		date = dt.Format(L"%d/%m/%Y");
-		break;
-	case ARBDateFormat::DashMDY: ///< M-D-Y
-		// wxDateTime only has zero/space padded days, zero padded months
-		date = wxString::Format(L"%d-%d-%d", mon, day, yr);
-		break;
-	case ARBDateFormat::SlashMDY: ///< M/D/Y
-		date = wxString::Format(L"%d/%d/%d", mon, day, yr);
-		break;
-	case ARBDateFormat::DashYMD: ///< Y-M-D
-		date = wxString::Format(L"%d-%d-%d", yr, mon, day);
-		break;
-	case ARBDateFormat::SlashYMD: ///< Y/M/D
-		date = wxString::Format(L"%d/%d/%d", yr, mon, day);
-		break;
-	case ARBDateFormat::DashDMY: ///< D-M-Y
-		date = wxString::Format(L"%d-%d-%d", day, mon, yr);
-		break;
-	case ARBDateFormat::SlashDMY: ///< D/M/Y
-		date = wxString::Format(L"%d/%d/%d", day, mon, yr);
-		break;
+		wchar_t buffer[MaxFormatLength];
+		ioString.append(buffer, FormatNumeric(buffer, inFormat, yr, mon, day));
 	}
-	return date;
 }
 
 
-void ARBDate::GetDate(int& outYr, int& outMon, int& outDay) const
+size_t ARBDate::FormatTo(char* outBuffer, ARBDateFormat inFormat) const
 {
-	SdnToGregorian(m_Julian, &outYr, &outMon, &outDay);
+	if (!IsValid())
+		return 0;
+	int yr, mon, day;
+	SdnToGregorian(m_Julian, yr, mon, day);
+	return FormatNumeric(outBuffer, inFormat, yr, mon, day);
 }
 
 
@@ -435,15 +848,10 @@ bool ARBDate::GetDate(time_t& outTime) const
 	if (0 < m_Julian)
 	{
 		int yr, mon, day;
-		SdnToGregorian(m_Julian, &yr, &mon, &day);
+		SdnToGregorian(m_Julian, yr, mon, day);
 		struct tm tim = {0};
 		// This initializes tm_isdst properly.
-		time_t inTime = time(nullptr);
-#if defined(ARB_HAS_SECURE_LOCALTIME)
-		_localtime64_s(&tim, &inTime);
-#else
-		tim = *localtime(&inTime);
-#endif
+		LocalTime(time(nullptr), tim);
 		int dst = tim.tm_isdst;
 		tim.tm_sec = 0;
 		tim.tm_min = 0;
@@ -478,7 +886,7 @@ bool ARBDate::GetDate(SYSTEMTIME& outTime) const
 	if (0 < m_Julian)
 	{
 		int yr, mon, day;
-		SdnToGregorian(m_Julian, &yr, &mon, &day);
+		SdnToGregorian(m_Julian, yr, mon, day);
 		outTime.wYear = static_cast<WORD>(yr);
 		outTime.wMonth = static_cast<WORD>(mon);
 		outTime.wDayOfWeek = static_cast<WORD>(GetDayOfWeek());
@@ -507,34 +915,103 @@ bool ARBDate::GetDate(wxDateTime& outDate) const
 #endif
 
 
-int ARBDate::GetDay() const
+// static
+void ARBDate::GetDates(long const* inJulian, size_t inCount, int* outYr, int* outMon, int* outDay)
 {
-	int yr, mon, day;
-	SdnToGregorian(m_Julian, &yr, &mon, &day);
-	return day;
+	for (size_t i = 0; i < inCount; ++i)
+	{
+		int32_t yr, mon, day;
+		SdnToGregorianBatch(inJulian[i], yr, mon, day);
+		outYr[i] = yr;
+		outMon[i] = mon;
+		outDay[i] = day;
+	}
 }
 
 
-int ARBDate::GetMonth() const
+// static
+void ARBDate::GetDaysOfWeek(long const* inJulian, size_t inCount, int* outDayOfWeek, ARBDayOfWeek inFirstDay)
 {
-	int yr, mon, day;
-	SdnToGregorian(m_Julian, &yr, &mon, &day);
-	return mon;
+	int32_t const firstDay = static_cast<int32_t>(inFirstDay);
+	for (size_t i = 0; i < inCount; ++i)
+		outDayOfWeek[i] = DayOfWeekBatch(inJulian[i], firstDay);
 }
 
 
-int ARBDate::GetYear() const
+// static
+void ARBDate::GetDaysOfYear(long const* inJulian, size_t inCount, int* outDayOfYear)
 {
-	int yr, mon, day;
-	SdnToGregorian(m_Julian, &yr, &mon, &day);
-	return yr;
+	for (size_t i = 0; i < inCount; ++i)
+	{
+		int32_t yr, mon, day;
+		SdnToGregorianBatch(inJulian[i], yr, mon, day);
+		int32_t const mask = -static_cast<int32_t>(IsBatchValid(inJulian[i]));
+		outDayOfYear[i] = (static_cast<int32_t>(inJulian[i]) - FirstDayOfYear(yr) + 1) & mask;
+	}
 }
 
 
-int ARBDate::GetDayOfYear() const
+// static
+void ARBDate::CountByPeriod(
+	long const* inJulian,
+	size_t inCount,
+	ARBDatePeriod inPeriod,
+	std::vector<ARBDatePeriodCount>& outCounts,
+	ARBDayOfWeek inFirstDay)
 {
-	ARBDate d(GetYear(), 1, 1);
-	return *this - d + 1;
+	outCounts.clear();
+	int32_t const firstDay = static_cast<int32_t>(inFirstDay);
+
+	std::vector<uint32_t> keys(inCount);
+	switch (inPeriod)
+	{
+	case ARBDatePeriod::Week:
+		GetPeriodKeys<ARBDatePeriod::Week>(inJulian, inCount, firstDay, keys.data());
+		break;
+	case ARBDatePeriod::Month:
+		GetPeriodKeys<ARBDatePeriod::Month>(inJulian, inCount, firstDay, keys.data());
+		break;
+	case ARBDatePeriod::Year:
+		GetPeriodKeys<ARBDatePeriod::Year>(inJulian, inCount, firstDay, keys.data());
+		break;
+	}
+
+	uint32_t minKey = UINT32_MAX;
+	uint32_t maxKey = 0;
+	for (auto key : keys)
+	{
+		minKey = std::min(minKey, key);
+		maxKey = std::max(maxKey, UINT32_MAX == key ? 0u : key);
+	}
+	if (UINT32_MAX == minKey)
+		return;
+
+	// Count into a dense array, unless the dates are very spread out.
+	size_t const range = static_cast<size_t>(maxKey - minKey) + 1;
+	if (range <= std::max<size_t>(inCount, 64 * 1024))
+	{
+		// The extra slot collects invalid dates.
+		std::vector<size_t> counts(range + 1, 0);
+		for (auto key : keys)
+			++counts[std::min(key - minKey, static_cast<uint32_t>(range))];
+		for (size_t i = 0; i < range; ++i)
+		{
+			if (0 < counts[i])
+				outCounts.push_back({PeriodStart(minKey + static_cast<uint32_t>(i), inPeriod, firstDay), counts[i]});
+		}
+	}
+	else
+	{
+		std::sort(keys.begin(), keys.end());
+		for (size_t i = 0; i < keys.size() && UINT32_MAX != keys[i];)
+		{
+			size_t next = i + 1;
+			while (next < keys.size() && keys[next] == keys[i])
+				++next;
+			outCounts.push_back({PeriodStart(keys[i], inPeriod, firstDay), next - i});
+			i = next;
+		}
+	}
 }
 
 } // namespace ARBCommon
@@ -9,6 +9,11 @@
  * @brief File hashing algorithms
  *
  * Revision History
+ * 2026-10-19 Read files instead of mapping them on POSIX (truncation: SIGBUS).
+ * 2026-10-19 Added Compute(filename): memory-maps regular files.
+ * 2026-10-19 Added SHA384, SHA512 and XXH64.
+ * 2026-10-19 Added computing several digests in one pass.
+ * 2026-10-19 Added ComputeMany for hashing batches of files in parallel.
  * 2013-10-29 Added more hash algorithms
  * 2012-04-10 Based on wx-group thread, use std::string for internal use
  * 2010-02-07 Created
@@ -19,7 +24,19 @@
 
 #include "ARBMsgDigestImpl.h"
 
+#include "ARBCommon/ParallelFor.h"
 #include "ARBCommon/StringUtil.h"
+#include <cerrno>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#if defined(__WXMSW__)
+#include <wx/msw/wrapwin.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 
 #if defined(__WXMSW__)
 #include <wx/msw/msvcrt.h>
@@ -30,32 +47,430 @@ namespace dconSoft
 {
 namespace ARBCommon
 {
+namespace
+{
+// Read size for files that are not memory mapped (all files on POSIX; pipes
+// and mapping failures on Windows).
+constexpr size_t FileReadBlockSize = 1024 * 1024;
+// Regular files are mapped this much at a time (Windows). This bounds the address
+// space used (32bit builds) while still handing the hash large spans.
+// Must be a multiple of the page size (and allocation granularity on Windows).
+constexpr uint64_t FileMapWindowSize = 64 * 1024 * 1024;
+
+// Read size used when computing several digests in one pass.
+constexpr size_t MultiReadBlockSize = 256 * 1024;
+// Number of blocks in the ring shared by the threaded multi-digest readers.
+constexpr size_t MultiReadRingSize = 4;
+
+
+std::unique_ptr<IMsgDigestContext> CreateContext(ARBMsgDigest::ARBDigest type)
+{
+	switch (type)
+	{
+	case ARBMsgDigest::ARBDigest::Unknown:
+		break;
+	case ARBMsgDigest::ARBDigest::MD5:
+		return ARBMsgDigestCreateMD5();
+	case ARBMsgDigest::ARBDigest::SHA1:
+		return ARBMsgDigestCreateSHA1();
+	case ARBMsgDigest::ARBDigest::SHA256:
+		return ARBMsgDigestCreateSHA256();
+	case ARBMsgDigest::ARBDigest::SHA384:
+		return ARBMsgDigestCreateSHA384();
+	case ARBMsgDigest::ARBDigest::SHA512:
+		return ARBMsgDigestCreateSHA512();
+	case ARBMsgDigest::ARBDigest::XXH64:
+		return ARBMsgDigestCreateXXH64();
+	}
+	return nullptr;
+}
+
 
-wxString ARBMsgDigest::Compute(std::istream& inFile, ARBDigest type, size_t* outSize)
+// Returns number of bytes read, 0 at end of data (or error).
+size_t ReadBlock(std::istream& inFile, unsigned char* buffer, size_t size)
+{
+	if (!inFile.good())
+		return 0;
+	inFile.read(reinterpret_cast<char*>(buffer), static_cast<std::streamsize>(size));
+	std::streamsize bytes = inFile.gcount();
+	return 0 < bytes ? static_cast<size_t>(bytes) : 0;
+}
+
+
+/**
+ * Single reader, multiple consumers. The reader fills blocks in a ring, each
+ * digest runs on its own thread and releases a block once it has hashed it.
+ * A block is refilled only after every consumer has released it.
+ */
+class CDigestBlockRing
+{
+public:
+	explicit CDigestBlockRing(size_t nConsumers)
+		: m_nConsumers(nConsumers)
+		, m_blocks(MultiReadRingSize)
+	{
+		for (auto& block : m_blocks)
+			block.data.resize(MultiReadBlockSize);
+	}
+
+	void Produce(std::istream& inFile, size_t* outSize)
+	{
+		for (size_t n = 0;; ++n)
+		{
+			Block& block = m_blocks[n % m_blocks.size()];
+			{
+				std::unique_lock<std::mutex> lock(m_lock);
+				m_cond.wait(lock, [&block]() { return 0 == block.pending; });
+			}
+			// No consumer touches a block with nothing pending.
+			size_t bytes = ReadBlock(inFile, block.data.data(), block.data.size());
+			std::lock_guard<std::mutex> lock(m_lock);
+			if (0 == bytes)
+			{
+				m_finished = true;
+				m_cond.notify_all();
+				return;
+			}
+			if (outSize)
+				*outSize += bytes;
+			block.size = bytes;
+			block.pending = m_nConsumers;
+			m_produced = n + 1;
+			m_cond.notify_all();
+		}
+	}
+
+	// Stop the consumers once they've hashed what was already produced
+	// (used when reading fails with an exception).
+	void Close()
+	{
+		std::lock_guard<std::mutex> lock(m_lock);
+		m_finished = true;
+		m_cond.notify_all();
+	}
+
+	void Consume(IMsgDigestContext& context)
+	{
+		for (size_t n = 0;; ++n)
+		{
+			Block& block = m_blocks[n % m_blocks.size()];
+			{
+				std::unique_lock<std::mutex> lock(m_lock);
+				m_cond.wait(lock, [this, n]() { return m_produced > n || m_finished; });
+				if (m_produced <= n)
+					return;
+			}
+			context.Update(block.data.data(), block.size);
+			std::lock_guard<std::mutex> lock(m_lock);
+			--block.pending;
+			m_cond.notify_all();
+		}
+	}
+
+private:
+	struct Block
+	{
+		std::vector<unsigned char> data;
+		size_t size = 0;
+		size_t pending = 0;
+	};
+
+	size_t m_nConsumers;
+	std::vector<Block> m_blocks;
+	std::mutex m_lock;
+	std::condition_variable m_cond;
+	size_t m_produced = 0;
+	bool m_finished = false;
+};
+
+
+#if defined(__WXMSW__)
+
+ARBMsgDigest::ARBDigestError DigestFile(wxString const& inFileName, IMsgDigestContext& context, size_t* outSize)
+{
+	HANDLE hFile = CreateFileW(
+		inFileName.wc_str(),
+		GENERIC_READ,
+		FILE_SHARE_READ | FILE_SHARE_WRITE,
+		nullptr,
+		OPEN_EXISTING,
+		FILE_FLAG_SEQUENTIAL_SCAN,
+		nullptr);
+	if (INVALID_HANDLE_VALUE == hFile)
+		return ARBMsgDigest::ARBDigestError::OpenFailed;
+
+	uint64_t done = 0;
+	bool bMapped = false;
+	LARGE_INTEGER fileSize;
+	if (GetFileType(hFile) == FILE_TYPE_DISK && GetFileSizeEx(hFile, &fileSize))
+	{
+		uint64_t size = static_cast<uint64_t>(fileSize.QuadPart);
+		// Can't map an empty file.
+		HANDLE hMap = 0 < size ? CreateFileMappingW(hFile, nullptr, PAGE_READONLY, 0, 0, nullptr) : nullptr;
+		if (hMap)
+		{
+			bMapped = true;
+			while (done < size)
+			{
+				auto len = static_cast<size_t>(std::min(FileMapWindowSize, size - done));
+				void* pView = MapViewOfFile(
+					hMap,
+					FILE_MAP_READ,
+					static_cast<DWORD>(done >> 32),
+					static_cast<DWORD>(done & 0xFFFFFFFF),
+					len);
+				if (!pView)
+				{
+					bMapped = false;
+					break;
+				}
+				context.Update(static_cast<unsigned char const*>(pView), len);
+				UnmapViewOfFile(pView);
+				done += len;
+			}
+			CloseHandle(hMap);
+		}
+		else if (0 == size)
+		{
+			bMapped = true;
+		}
+	}
+
+	auto rc = ARBMsgDigest::ARBDigestError::None;
+	if (!bMapped)
+	{
+		LARGE_INTEGER offset;
+		offset.QuadPart = static_cast<LONGLONG>(done);
+		if (0 < done && !SetFilePointerEx(hFile, offset, nullptr, FILE_BEGIN))
+			rc = ARBMsgDigest::ARBDigestError::ReadFailed;
+		std::vector<unsigned char> buffer(FileReadBlockSize);
+		while (ARBMsgDigest::ARBDigestError::None == rc)
+		{
+			DWORD bytes = 0;
+			if (!ReadFile(hFile, buffer.data(), static_cast<DWORD>(buffer.size()), &bytes, nullptr))
+				rc = ARBMsgDigest::ARBDigestError::ReadFailed;
+			else if (0 == bytes)
+				break;
+			else
+			{
+				context.Update(buffer.data(), bytes);
+				done += bytes;
+			}
+		}
+	}
+	CloseHandle(hFile);
+
+	if (outSize)
+		*outSize = static_cast<size_t>(done);
+	return rc;
+}
+
+#else
+
+// Files are read, not mapped: if another process truncates a mapped file,
+// touching the lost pages raises SIGBUS. A read just comes up short.
+ARBMsgDigest::ARBDigestError DigestFile(wxString const& inFileName, IMsgDigestContext& context, size_t* outSize)
+{
+	int fd = open(inFileName.utf8_string().c_str(), O_RDONLY | O_CLOEXEC);
+	if (0 > fd)
+		return ARBMsgDigest::ARBDigestError::OpenFailed;
+
+#if defined(POSIX_FADV_SEQUENTIAL)
+	posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#elif defined(F_RDAHEAD)
+	fcntl(fd, F_RDAHEAD, 1);
+#endif
+	auto rc = ARBMsgDigest::ARBDigestError::None;
+	uint64_t done = 0;
+	std::vector<unsigned char> buffer(FileReadBlockSize);
+	while (ARBMsgDigest::ARBDigestError::None == rc)
+	{
+		ssize_t bytes = read(fd, buffer.data(), buffer.size());
+		if (0 > bytes)
+		{
+			if (EINTR != errno)
+				rc = ARBMsgDigest::ARBDigestError::ReadFailed;
+		}
+		else if (0 == bytes)
+			break;
+		else
+		{
+			context.Update(buffer.data(), static_cast<size_t>(bytes));
+			done += static_cast<uint64_t>(bytes);
+		}
+	}
+	close(fd);
+
+	if (outSize)
+		*outSize = static_cast<size_t>(done);
+	return rc;
+}
+
+#endif
+
+
+ARBMsgDigest::ARBDigestResult ComputeResult(std::istream& inFile, ARBMsgDigest::ARBDigest type)
+{
+	ARBMsgDigest::ARBDigestResult result;
+	result.digest = ARBMsgDigest::Compute(inFile, type, &result.size);
+	if (inFile.bad() || (result.digest.empty() && ARBMsgDigest::ARBDigest::Unknown != type))
+	{
+		result.error = ARBMsgDigest::ARBDigestError::ReadFailed;
+		result.digest.clear();
+	}
+	return result;
+}
+
+
+ARBMsgDigest::ARBDigestResult ComputeResult(wxString const& inFileName, ARBMsgDigest::ARBDigest type)
+{
+	ARBMsgDigest::ARBDigestResult result;
+	auto context = CreateContext(type);
+	if (!context)
+	{
+		assert(0);
+		return result;
+	}
+	result.error = DigestFile(inFileName, *context, &result.size);
+	if (ARBMsgDigest::ARBDigestError::None == result.error)
+		result.digest = context->Final();
+	return result;
+}
+} // namespace
+
+
+wxString ARBMsgDigest::Compute(std::istream& inFile, ARBDigest type, size_t* outSize, size_t inBufferSize)
 {
 	if (outSize)
 		*outSize = 0;
 	if (!inFile.good())
 		return wxString();
 
-	switch (type)
+	auto context = CreateContext(type);
+	if (!context)
 	{
-	case ARBDigest::Unknown:
 		assert(0);
 		return wxString();
+	}
+
+	std::vector<unsigned char> buffer(std::max<size_t>(inBufferSize, 1));
+	for (size_t bytes = ReadBlock(inFile, buffer.data(), buffer.size()); 0 < bytes;
+		 bytes = ReadBlock(inFile, buffer.data(), buffer.size()))
+	{
+		if (outSize)
+			*outSize += bytes;
+		context->Update(buffer.data(), bytes);
+	}
+	return context->Final();
+}
+
 
-	case ARBDigest::MD5:
-		return ARBMsgDigestComputeMD5(inFile, outSize);
+wxString ARBMsgDigest::Compute(wxString const& inFileName, ARBDigest type, size_t* outSize)
+{
+	ARBDigestResult result = ComputeResult(inFileName, type);
+	if (outSize)
+		*outSize = result.size;
+	return result.digest;
+}
+
+
+std::map<ARBMsgDigest::ARBDigest, wxString> ARBMsgDigest::Compute(
+	std::istream& inFile,
+	std::set<ARBDigest> const& types,
+	size_t* outSize,
+	bool bThreaded)
+{
+	if (outSize)
+		*outSize = 0;
+	std::map<ARBDigest, wxString> digests;
+	if (!inFile.good())
+		return digests;
 
-	case ARBDigest::SHA1:
-		return ARBMsgDigestComputeSHA1(inFile, outSize);
+	std::vector<std::pair<ARBDigest, std::unique_ptr<IMsgDigestContext>>> contexts;
+	for (auto type : types)
+	{
+		auto context = CreateContext(type);
+		if (!context)
+		{
+			assert(0);
+			continue;
+		}
+		contexts.emplace_back(type, std::move(context));
+	}
+	if (contexts.empty())
+		return digests;
 
-	case ARBDigest::SHA256:
-		return ARBMsgDigestComputeSHA256(inFile, outSize);
+	if (bThreaded && 1 < contexts.size())
+	{
+		CDigestBlockRing ring(contexts.size());
+		std::vector<std::thread> threads;
+		// A joinable thread's destructor calls std::terminate, so the threads
+		// must be joined even if starting one or reading the stream throws.
+		try
+		{
+			threads.reserve(contexts.size());
+			for (auto& context : contexts)
+			{
+				IMsgDigestContext* pContext = context.second.get();
+				threads.emplace_back([&ring, pContext]() { ring.Consume(*pContext); });
+			}
+			ring.Produce(inFile, outSize);
+		}
+		catch (...)
+		{
+			ring.Close();
+			for (auto& thread : threads)
+				thread.join();
+			throw;
+		}
+		for (auto& thread : threads)
+			thread.join();
 	}
+	else
+	{
+		std::vector<unsigned char> buffer(MultiReadBlockSize);
+		for (size_t bytes = ReadBlock(inFile, buffer.data(), buffer.size()); 0 < bytes;
+			 bytes = ReadBlock(inFile, buffer.data(), buffer.size()))
+		{
+			if (outSize)
+				*outSize += bytes;
+			for (auto& context : contexts)
+				context.second->Update(buffer.data(), bytes);
+		}
+	}
+
+	for (auto& context : contexts)
+		digests[context.first] = context.second->Final();
+	return digests;
+}
 
-	// 'enum class' handles all cases via the switch above
-	return wxString();
+
+std::vector<ARBMsgDigest::ARBDigestResult> ARBMsgDigest::ComputeMany(
+	std::vector<wxString> const& inFiles,
+	ARBDigest type,
+	size_t nThreads)
+{
+	std::vector<ARBDigestResult> results(inFiles.size());
+	ParallelFor(inFiles.size(), nThreads, [&inFiles, &results, type](size_t idx) {
+		results[idx] = ComputeResult(inFiles[idx], type);
+	});
+	return results;
+}
+
+
+std::vector<ARBMsgDigest::ARBDigestResult> ARBMsgDigest::ComputeMany(
+	std::vector<std::istream*> const& inStreams,
+	ARBDigest type,
+	size_t nThreads)
+{
+	std::vector<ARBDigestResult> results(inStreams.size());
+	ParallelFor(inStreams.size(), nThreads, [&inStreams, &results, type](size_t idx) {
+		if (!inStreams[idx])
+			results[idx].error = ARBDigestError::OpenFailed;
+		else
+			results[idx] = ComputeResult(*inStreams[idx], type);
+	});
+	return results;
 }
 
 } // namespace ARBCommon
@@ -0,0 +1,626 @@
+/*
+ * Copyright (c) David Connet. All Rights Reserved.
+ *
+ * License: See License.txt
+ */
+
+/**
+ * @file
+ * @brief Persistent cache of file digests
+ * @author David Connet
+ *
+ * Journal format (utf8, one entry per line, tab separated):
+ *  Header: "ARBDigestCache<tab>1"
+ *  Entry:  type size mtime fileid digest path
+ * mtime is in the platform's native units (ns on posix, 100ns on Windows).
+ * The path is last so it may contain tabs. A line without a trailing newline
+ * is an interrupted write and is ignored.
+ *
+ * Revision History
+ * 2026-10-19 Created
+ */
+
+#include "stdafx.h"
+#include "ARBCommon/ARBMsgDigestCache.h"
+
+#include <wx/filename.h>
+#include <cerrno>
+#include <cstdlib>
+#include <fstream>
+#include <mutex>
+
+#if defined(__WXMSW__)
+#include <wx/msw/wrapwin.h>
+#else
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined(__WXMSW__)
+#include <wx/msw/msvcrt.h>
+#endif
+
+
+namespace dconSoft
+{
+namespace ARBCommon
+{
+namespace ARBMsgDigest
+{
+namespace
+{
+constexpr char JournalHeader[] = "ARBDigestCache\t1";
+
+struct FileIdentity
+{
+	uint64_t size = 0;
+	int64_t mtime = 0;
+	uint64_t fileId = 0;
+
+	bool operator==(FileIdentity const& rhs) const
+	{
+		return size == rhs.size && mtime == rhs.mtime && fileId == rhs.fileId;
+	}
+	bool operator!=(FileIdentity const& rhs) const
+	{
+		return !operator==(rhs);
+	}
+};
+
+
+struct CacheEntry
+{
+	FileIdentity id;
+	wxString digest;
+};
+
+
+struct DigestName
+{
+	ARBDigest type;
+	char const* name;
+};
+constexpr DigestName DigestNames[] = {
+	{ARBDigest::MD5, "MD5"},
+	{ARBDigest::SHA1, "SHA1"},
+	{ARBDigest::SHA256, "SHA256"},
+	{ARBDigest::SHA384, "SHA384"},
+	{ARBDigest::SHA512, "SHA512"},
+	{ARBDigest::XXH64, "XXH64"},
+};
+
+
+char const* GetDigestName(ARBDigest type)
+{
+	for (auto const& name : DigestNames)
+	{
+		if (name.type == type)
+			return name.name;
+	}
+	return nullptr;
+}
+
+
+ARBDigest GetDigestType(std::string const& inName)
+{
+	for (auto const& name : DigestNames)
+	{
+		if (inName == name.name)
+			return name.type;
+	}
+	return ARBDigest::Unknown;
+}
+
+
+wxString CanonicalPath(wxString const& inFileName)
+{
+	wxFileName filename(inFileName);
+	filename.Normalize(wxPATH_NORM_DOTS | wxPATH_NORM_ABSOLUTE | wxPATH_NORM_LONG);
+	return filename.GetFullPath();
+}
+
+
+#if defined(__WXMSW__)
+
+bool GetFileIdentity(wxString const& inFileName, FileIdentity& outId)
+{
+	HANDLE hFile = CreateFileW(
+		inFileName.wc_str(),
+		FILE_READ_ATTRIBUTES,
+		FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+		nullptr,
+		OPEN_EXISTING,
+		FILE_FLAG_BACKUP_SEMANTICS,
+		nullptr);
+	if (INVALID_HANDLE_VALUE == hFile)
+		return false;
+	BY_HANDLE_FILE_INFORMATION info;
+	bool bOk = !!GetFileInformationByHandle(hFile, &info);
+	CloseHandle(hFile);
+	if (!bOk)
+		return false;
+	outId.size = (static_cast<uint64_t>(info.nFileSizeHigh) << 32) | info.nFileSizeLow;
+	outId.mtime = static_cast<int64_t>(
+		(static_cast<uint64_t>(info.ftLastWriteTime.dwHighDateTime) << 32) | info.ftLastWriteTime.dwLowDateTime);
+	outId.fileId = (static_cast<uint64_t>(info.nFileIndexHigh) << 32) | info.nFileIndexLow;
+	return true;
+}
+
+
+// Exclusive lock on a separate file, so the journal itself can be replaced.
+class CCacheLock
+{
+	DECLARE_NO_COPY_IMPLEMENTED(CCacheLock)
+public:
+	explicit CCacheLock(wxString const& inLockFile)
+		: m_hFile(CreateFileW(
+			inLockFile.wc_str(),
+			GENERIC_READ | GENERIC_WRITE,
+			FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+			nullptr,
+			OPEN_ALWAYS,
+			FILE_ATTRIBUTE_NORMAL,
+			nullptr))
+		, m_bLocked(false)
+	{
+		if (INVALID_HANDLE_VALUE != m_hFile)
+		{
+			OVERLAPPED overlapped = {};
+			m_bLocked = !!LockFileEx(m_hFile, LOCKFILE_EXCLUSIVE_LOCK, 0, 1, 0, &overlapped);
+		}
+	}
+	~CCacheLock()
+	{
+		if (INVALID_HANDLE_VALUE != m_hFile)
+		{
+			if (m_bLocked)
+			{
+				OVERLAPPED overlapped = {};
+				UnlockFileEx(m_hFile, 0, 1, 0, &overlapped);
+			}
+			CloseHandle(m_hFile);
+		}
+	}
+	bool IsLocked() const
+	{
+		return m_bLocked;
+	}
+
+private:
+	HANDLE m_hFile;
+	bool m_bLocked;
+};
+
+#else
+
+bool GetFileIdentity(wxString const& inFileName, FileIdentity& outId)
+{
+	struct stat s;
+	if (0 != stat(inFileName.utf8_string().c_str(), &s))
+		return false;
+	outId.size = static_cast<uint64_t>(s.st_size);
+#if defined(__APPLE__)
+	outId.mtime = static_cast<int64_t>(s.st_mtimespec.tv_sec) * 1000000000 + s.st_mtimespec.tv_nsec;
+#else
+	outId.mtime = static_cast<int64_t>(s.st_mtim.tv_sec) * 1000000000 + s.st_mtim.tv_nsec;
+#endif
+	outId.fileId = static_cast<uint64_t>(s.st_ino);
+	return true;
+}
+
+
+// Exclusive lock on a separate file, so the journal itself can be replaced.
+class CCacheLock
+{
+	DECLARE_NO_COPY_IMPLEMENTED(CCacheLock)
+public:
+	explicit CCacheLock(wxString const& inLockFile)
+		: m_fd(open(inLockFile.utf8_string().c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644))
+		, m_bLocked(false)
+	{
+		if (0 <= m_fd)
+		{
+			int rc;
+			do
+			{
+				rc = flock(m_fd, LOCK_EX);
+			} while (0 != rc && EINTR == errno);
+			m_bLocked = (0 == rc);
+		}
+	}
+	~CCacheLock()
+	{
+		if (0 <= m_fd)
+		{
+			if (m_bLocked)
+				flock(m_fd, LOCK_UN);
+			close(m_fd);
+		}
+	}
+	bool IsLocked() const
+	{
+		return m_bLocked;
+	}
+
+private:
+	int m_fd;
+	bool m_bLocked;
+};
+
+#endif
+} // namespace
+
+
+class ARBDigestCacheImpl
+{
+	DECLARE_NO_COPY_IMPLEMENTED(ARBDigestCacheImpl)
+public:
+	explicit ARBDigestCacheImpl(wxString const& inCacheFile);
+
+	bool Lookup(wxString const& inPath, ARBDigest type, FileIdentity const& id, wxString& outDigest) const;
+	void Add(wxString const& inPath, ARBDigest type, FileIdentity const& id, wxString const& digest);
+	bool Flush();
+	bool Compact();
+	size_t size() const;
+
+private:
+	typedef std::pair<wxString, ARBDigest> CacheKey;
+
+	// These must be called with both m_lock and the file lock held.
+	void MergeJournal();
+	bool ReadJournal();
+	bool RewriteJournal();
+	bool WriteEntry(std::ostream& output, CacheKey const& key, CacheEntry const& entry) const;
+
+	wxString m_cacheFile;
+	wxString m_lockFile;
+	mutable std::mutex m_lock;
+	std::map<CacheKey, CacheEntry> m_entries;
+	std::set<CacheKey> m_pending;
+	// What we've read of the journal. If the journal is replaced (compacted
+	// by someone else) or shrinks, it's re-read from the start.
+	FileIdentity m_journalId;
+	uint64_t m_journalOffset;
+	bool m_journalBad;
+};
+
+
+ARBDigestCacheImpl::ARBDigestCacheImpl(wxString const& inCacheFile)
+	: m_cacheFile(CanonicalPath(inCacheFile))
+	, m_lockFile(m_cacheFile + L".lock")
+	, m_lock()
+	, m_entries()
+	, m_pending()
+	, m_journalId()
+	, m_journalOffset(0)
+	, m_journalBad(false)
+{
+	std::lock_guard<std::mutex> lock(m_lock);
+	CCacheLock fileLock(m_lockFile);
+	if (fileLock.IsLocked())
+		ReadJournal();
+}
+
+
+bool ARBDigestCacheImpl::Lookup(wxString const& inPath, ARBDigest type, FileIdentity const& id, wxString& outDigest)
+	const
+{
+	std::lock_guard<std::mutex> lock(m_lock);
+	auto iter = m_entries.find(CacheKey(inPath, type));
+	if (iter == m_entries.end() || iter->second.id != id)
+		return false;
+	outDigest = iter->second.digest;
+	return true;
+}
+
+
+void ARBDigestCacheImpl::Add(wxString const& inPath, ARBDigest type, FileIdentity const& id, wxString const& digest)
+{
+	std::lock_guard<std::mutex> lock(m_lock);
+	CacheKey key(inPath, type);
+	auto iter = m_entries.find(key);
+	if (iter != m_entries.end() && iter->second.id == id && iter->second.digest == digest)
+		return;
+	m_entries[key] = CacheEntry{id, digest};
+	m_pending.insert(key);
+}
+
+
+bool ARBDigestCacheImpl::Flush()
+{
+	std::lock_guard<std::mutex> lock(m_lock);
+	if (m_pending.empty())
+		return true;
+
+	CCacheLock fileLock(m_lockFile);
+	if (!fileLock.IsLocked())
+		return false;
+
+	MergeJournal();
+	if (m_journalBad)
+		return RewriteJournal();
+
+	FileIdentity id;
+	bool bCreate = !GetFileIdentity(m_cacheFile, id) || 0 == id.size;
+#ifdef ARB_HAS_ISTREAM_WCHAR
+	std::ofstream output(m_cacheFile.wc_str(), std::ios::binary | std::ios::app);
+#else
+	std::ofstream output(m_cacheFile.utf8_string(), std::ios::binary | std::ios::app);
+#endif
+	if (!output.good())
+		return false;
+	if (bCreate)
+		output << JournalHeader << '\n';
+	else if (id.size > m_journalOffset)
+		output << '\n'; // Terminate an interrupted write.
+	for (auto const& key : m_pending)
+		WriteEntry(output, key, m_entries[key]);
+	output.close();
+	if (output.fail())
+		return false;
+	m_pending.clear();
+
+	// We hold the lock and read to the end before appending, so the file
+	// now ends with what we wrote.
+	if (GetFileIdentity(m_cacheFile, id))
+	{
+		m_journalId = id;
+		m_journalOffset = id.size;
+	}
+	return true;
+}
+
+
+bool ARBDigestCacheImpl::Compact()
+{
+	std::lock_guard<std::mutex> lock(m_lock);
+	CCacheLock fileLock(m_lockFile);
+	if (!fileLock.IsLocked())
+		return false;
+
+	MergeJournal();
+	for (auto iter = m_entries.begin(); iter != m_entries.end();)
+	{
+		FileIdentity id;
+		if (!GetFileIdentity(iter->first.first, id) || id != iter->second.id)
+			iter = m_entries.erase(iter);
+		else
+			++iter;
+	}
+	return RewriteJournal();
+}
+
+
+size_t ARBDigestCacheImpl::size() const
+{
+	std::lock_guard<std::mutex> lock(m_lock);
+	return m_entries.size();
+}
+
+
+void ARBDigestCacheImpl::MergeJournal()
+{
+	// Pick up anything other processes added. Our pending entries are newer.
+	std::map<CacheKey, CacheEntry> pending;
+	for (auto const& key : m_pending)
+		pending[key] = m_entries[key];
+	ReadJournal();
+	for (auto const& entry : pending)
+		m_entries[entry.first] = entry.second;
+}
+
+
+bool ARBDigestCacheImpl::ReadJournal()
+{
+	FileIdentity id;
+	if (!GetFileIdentity(m_cacheFile, id))
+	{
+		// No journal yet (or it was deleted). Keep what we have in memory.
+		m_journalId = FileIdentity();
+		m_journalOffset = 0;
+		m_journalBad = false;
+		return true;
+	}
+	if (id.fileId != m_journalId.fileId || id.size < m_journalOffset)
+	{
+		m_journalOffset = 0;
+		m_journalBad = false;
+	}
+	if (id.size == m_journalOffset || m_journalBad)
+		return true;
+
+#ifdef ARB_HAS_ISTREAM_WCHAR
+	std::ifstream input(m_cacheFile.wc_str(), std::ios::binary);
+#else
+	std::ifstream input(m_cacheFile.utf8_string(), std::ios::binary);
+#endif
+	if (!input.good())
+		return false;
+
+	uint64_t offset = m_journalOffset;
+	bool bHeader = (0 == offset);
+	if (!bHeader)
+		input.seekg(static_cast<std::streamoff>(offset));
+
+	std::string line;
+	while (std::getline(input, line))
+	{
+		// Interrupted write: no newline.
+		if (input.eof())
+			break;
+		offset += line.size() + 1;
+		if (bHeader)
+		{
+			bHeader = false;
+			if (line != JournalHeader)
+			{
+				// Unknown format: ignore it, the next write will replace it.
+				m_journalBad = true;
+				break;
+			}
+			continue;
+		}
+
+		// type size mtime fileid digest path
+		size_t fields[5];
+		size_t pos = 0;
+		bool bOk = true;
+		for (size_t i = 0; bOk && i < _countof(fields); ++i)
+		{
+			size_t tab = line.find('\t', pos);
+			if (std::string::npos == tab)
+				bOk = false;
+			else
+			{
+				fields[i] = tab;
+				pos = tab + 1;
+			}
+		}
+		if (!bOk)
+			continue;
+		ARBDigest type = GetDigestType(line.substr(0, fields[0]));
+		if (ARBDigest::Unknown == type)
+			continue;
+		CacheEntry entry;
+		entry.id.size = std::strtoull(line.c_str() + fields[0] + 1, nullptr, 10);
+		entry.id.mtime = std::strtoll(line.c_str() + fields[1] + 1, nullptr, 10);
+		entry.id.fileId = std::strtoull(line.c_str() + fields[2] + 1, nullptr, 10);
+		entry.digest = wxString::FromUTF8(line.substr(fields[3] + 1, fields[4] - fields[3] - 1));
+		// Later lines supersede earlier ones.
+		m_entries[CacheKey(wxString::FromUTF8(line.substr(fields[4] + 1)), type)] = entry;
+	}
+	m_journalId = id;
+	m_journalOffset = offset;
+	return true;
+}
+
+
+bool ARBDigestCacheImpl::RewriteJournal()
+{
+	wxString tmpFile = m_cacheFile + L".tmp";
+	{
+#ifdef ARB_HAS_ISTREAM_WCHAR
+		std::ofstream output(tmpFile.wc_str(), std::ios::binary | std::ios::trunc);
+#else
+		std::ofstream output(tmpFile.utf8_string(), std::ios::binary | std::ios::trunc);
+#endif
+		if (!output.good())
+			return false;
+		output << JournalHeader << '\n';
+		for (auto const& entry : m_entries)
+			WriteEntry(output, entry.first, entry.second);
+		output.close();
+		if (output.fail())
+		{
+			wxRemoveFile(tmpFile);
+			return false;
+		}
+	}
+	// Everyone else is blocked on the lock file, so the journal isn't open.
+	if (!wxRenameFile(tmpFile, m_cacheFile, true))
+	{
+		wxRemoveFile(tmpFile);
+		return false;
+	}
+	m_pending.clear();
+	m_journalBad = false;
+	FileIdentity id;
+	if (GetFileIdentity(m_cacheFile, id))
+	{
+		m_journalId = id;
+		m_journalOffset = id.size;
+	}
+	return true;
+}
+
+
+bool ARBDigestCacheImpl::WriteEntry(std::ostream& output, CacheKey const& key, CacheEntry const& entry) const
+{
+	char const* name = GetDigestName(key.second);
+	if (!name)
+		return false;
+	output << name << '\t' << entry.id.size << '\t' << entry.id.mtime << '\t' << entry.id.fileId << '\t'
+		   << entry.digest.utf8_string() << '\t' << key.first.utf8_string() << '\n';
+	return true;
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+
+ARBDigestCache::ARBDigestCache(wxString const& inCacheFile)
+	: m_pImpl(new ARBDigestCacheImpl(inCacheFile))
+{
+}
+
+
+ARBDigestCache::~ARBDigestCache()
+{
+	m_pImpl->Flush();
+	delete m_pImpl;
+}
+
+
+bool ARBDigestCache::Lookup(wxString const& inFileName, ARBDigest type, wxString& outDigest, size_t* outSize) const
+{
+	wxString path = CanonicalPath(inFileName);
+	FileIdentity id;
+	if (!GetFileIdentity(path, id) || !m_pImpl->Lookup(path, type, id, outDigest))
+		return false;
+	if (outSize)
+		*outSize = static_cast<size_t>(id.size);
+	return true;
+}
+
+
+wxString ARBDigestCache::Compute(wxString const& inFileName, ARBDigest type, size_t* outSize)
+{
+	wxString path = CanonicalPath(inFileName);
+	FileIdentity id;
+	if (!GetFileIdentity(path, id))
+		return wxString();
+
+	wxString digest;
+	if (m_pImpl->Lookup(path, type, id, digest))
+	{
+		if (outSize)
+			*outSize = static_cast<size_t>(id.size);
+		return digest;
+	}
+
+	size_t size = 0;
+	digest = ARBMsgDigest::Compute(path, type, &size);
+	if (!digest.empty())
+	{
+		// Only cache if the file didn't change while we were reading it.
+		FileIdentity after;
+		if (GetFileIdentity(path, after) && after == id && size == id.size)
+			m_pImpl->Add(path, type, id, digest);
+	}
+	if (outSize)
+		*outSize = size;
+	return digest;
+}
+
+
+bool ARBDigestCache::Flush()
+{
+	return m_pImpl->Flush();
+}
+
+
+bool ARBDigestCache::Compact()
+{
+	return m_pImpl->Compact();
+}
+
+
+size_t ARBDigestCache::size() const
+{
+	return m_pImpl->size();
+}
+
+} // namespace ARBMsgDigest
+} // namespace ARBCommon
+} // namespace dconSoft
@@ -9,10 +9,13 @@
  * @brief File hashing algorithms
  *
  * Revision History
+ * 2026-10-19 Added SHA384, SHA512, XXH64.
+ * 2026-10-19 Changed to incremental contexts so data can be fed to several
+ *            algorithms from a single read.
  * 2013-10-29 Added more hash algorithms
  */
 
-#include <istream>
+#include <memory>
 
 
 namespace dconSoft
@@ -20,11 +23,30 @@ namespace dconSoft
 namespace ARBCommon
 {
 
-extern wxString ARBMsgDigestComputeMD5(std::istream& inFile, size_t* outSize);
+/**
+ * Incremental digest computation. One object per computation.
+ */
+class IMsgDigestContext
+{
+public:
+	virtual ~IMsgDigestContext() = default;
+	/// Add data to the digest.
+	virtual void Update(unsigned char const* data, size_t len) = 0;
+	/// Finish the computation. Returns the digest as a lower-case hex string.
+	virtual wxString Final() = 0;
+};
+
+extern std::unique_ptr<IMsgDigestContext> ARBMsgDigestCreateMD5();
+
+extern std::unique_ptr<IMsgDigestContext> ARBMsgDigestCreateSHA1();
+
+extern std::unique_ptr<IMsgDigestContext> ARBMsgDigestCreateSHA256();
+
+extern std::unique_ptr<IMsgDigestContext> ARBMsgDigestCreateSHA384();
 
-extern wxString ARBMsgDigestComputeSHA1(std::istream& inFile, size_t* outSize);
+extern std::unique_ptr<IMsgDigestContext> ARBMsgDigestCreateSHA512();
 
-extern wxString ARBMsgDigestComputeSHA256(std::istream& inFile, size_t* outSize);
+extern std::unique_ptr<IMsgDigestContext> ARBMsgDigestCreateXXH64();
 
 } // namespace ARBCommon
 } // namespace dconSoft
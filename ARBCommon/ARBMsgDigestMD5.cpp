@@ -16,6 +16,7 @@
  * the original external interfaces are]
  *
  * Revision History
+ * 2026-10-19 Converted to an incremental digest context.
  * 2015-11-27 Fixed UINT4 definition on Mac by using wx-defined sizes.
  * 2012-04-10 Based on wx-group thread, use std::string for internal use
  * 2010-02-07 Created
@@ -390,31 +391,44 @@ wxString ConvertDigest(const unsigned char digest[16])
 	return str;
 }
 
-} // namespace
-
-// Note, error checking of arguments handled in ARBMsgDigest::Compute
 
-wxString ARBMsgDigestComputeMD5(std::istream& inFile, size_t* outSize)
+class CMsgDigestMD5 : public IMsgDigestContext
 {
-	MD5_CTX context;
-	MD5Init(&context);
+public:
+	CMsgDigestMD5()
+	{
+		MD5Init(&m_context);
+	}
+
+	void Update(unsigned char const* data, size_t len) override
+	{
+		// MD5Update takes an unsigned int length.
+		while (0 < len)
+		{
+			auto chunk = static_cast<unsigned int>(std::min<size_t>(len, 0x40000000));
+			MD5Update(&m_context, data, chunk);
+			data += chunk;
+			len -= chunk;
+		}
+	}
 
-	while (inFile.good())
+	wxString Final() override
 	{
-		unsigned char buffer[1024];
-		inFile.read(reinterpret_cast<char*>(buffer), sizeof(buffer));
-		std::streamsize bytes = inFile.gcount();
-		if (0 >= bytes)
-			break;
-		if (outSize)
-			*outSize += static_cast<size_t>(bytes);
-		MD5Update(&context, buffer, bytes);
+		unsigned char digest[16];
+		MD5Final(digest, &m_context);
+		return ConvertDigest(digest);
 	}
 
-	unsigned char digest[16];
-	MD5Final(digest, &context);
+private:
+	MD5_CTX m_context;
+};
+
+} // namespace
+
 
-	return ConvertDigest(digest);
+std::unique_ptr<IMsgDigestContext> ARBMsgDigestCreateMD5()
+{
+	return std::make_unique<CMsgDigestMD5>();
 }
 
 } // namespace ARBCommon
@@ -19,6 +19,7 @@
  * This file combines license.txt, sha1.h, sha1.cpp
  *
  * Revision History
+ * 2026-10-19 Converted to an incremental digest context.
  * 2013-10-29 Created
  */
 
@@ -749,6 +750,10 @@ unsigned SHA1::CircularShift(int bits, unsigned word)
 // clang-format on
 /////////////////////////////////////////////////////////////////////////////
 
+namespace dconSoft
+{
+namespace ARBCommon
+{
 namespace
 {
 wxString ConvertDigest(const unsigned int digest[5])
@@ -760,37 +765,45 @@ wxString ConvertDigest(const unsigned int digest[5])
 	}
 	return str;
 }
-} // namespace
-
-namespace dconSoft
-{
-namespace ARBCommon
-{
 
-// Note, error checking of arguments handled in ARBMsgDigest::Compute
 
-wxString ARBMsgDigestComputeSHA1(std::istream& inFile, size_t* outSize)
+class CMsgDigestSHA1 : public IMsgDigestContext
 {
-	SHA1 sha;
-	sha.Reset();
+public:
+	CMsgDigestSHA1()
+	{
+		m_sha.Reset();
+	}
 
-	while (inFile.good())
+	void Update(unsigned char const* data, size_t len) override
 	{
-		unsigned char buffer[1024];
-		inFile.read(reinterpret_cast<char*>(buffer), sizeof(buffer));
-		std::streamsize bytes = inFile.gcount();
-		if (0 >= bytes)
-			break;
-		if (outSize)
-			*outSize += static_cast<size_t>(bytes);
-		sha.Input(buffer, static_cast<unsigned int>(bytes));
+		// SHA1::Input takes an unsigned int length.
+		while (0 < len)
+		{
+			auto chunk = static_cast<unsigned int>(std::min<size_t>(len, 0x40000000));
+			m_sha.Input(data, chunk);
+			data += chunk;
+			len -= chunk;
+		}
 	}
 
-	unsigned int message_digest[5];
-	if (!sha.Result(message_digest))
-		return wxString();
+	wxString Final() override
+	{
+		unsigned int message_digest[5];
+		if (!m_sha.Result(message_digest))
+			return wxString();
+		return ConvertDigest(message_digest);
+	}
 
-	return ConvertDigest(message_digest);
+private:
+	SHA1 m_sha;
+};
+} // namespace
+
+
+std::unique_ptr<IMsgDigestContext> ARBMsgDigestCreateSHA1()
+{
+	return std::make_unique<CMsgDigestSHA1>();
 }
 
 } // namespace ARBCommon
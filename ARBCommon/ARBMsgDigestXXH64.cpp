@@ -0,0 +1,209 @@
+/*
+ * Copyright (c) David Connet. All Rights Reserved.
+ *
+ * License: See License.txt
+ */
+
+/**
+ * @file
+ * @brief File hashing algorithms
+ *
+ * XXH64 is a fast non-cryptographic hash. Use it for change detection where
+ * collision resistance against an attacker is not needed. This is written
+ * from the algorithm description in the xxHash specification
+ * (https://github.com/Cyan4973/xxHash/blob/dev/doc/xxhash_spec.md).
+ * Output is the 64bit value (seed 0) as 16 lower-case hex digits, which
+ * matches the canonical (big endian) representation used by xxhsum.
+ *
+ * Revision History
+ * 2026-10-19 Created
+ */
+
+#include "stdafx.h"
+#include "ARBMsgDigestImpl.h"
+
+#include <cstring>
+
+#if defined(__WXMSW__)
+#include <wx/msw/msvcrt.h>
+#endif
+
+
+namespace dconSoft
+{
+namespace ARBCommon
+{
+namespace
+{
+constexpr uint64_t PRIME64_1 = 0x9E3779B185EBCA87ULL;
+constexpr uint64_t PRIME64_2 = 0xC2B2AE3D27D4EB4FULL;
+constexpr uint64_t PRIME64_3 = 0x165667B19E3779F9ULL;
+constexpr uint64_t PRIME64_4 = 0x85EBCA77C2B2AE63ULL;
+constexpr uint64_t PRIME64_5 = 0x27D4EB2F165667C5ULL;
+
+constexpr size_t StripeSize = 32;
+
+
+inline uint64_t RotL64(uint64_t value, int bits)
+{
+	return (value << bits) | (value >> (64 - bits));
+}
+
+
+// Input is little endian, regardless of platform.
+inline uint64_t Read64(unsigned char const* p)
+{
+	return static_cast<uint64_t>(p[0]) | (static_cast<uint64_t>(p[1]) << 8) | (static_cast<uint64_t>(p[2]) << 16)
+		   | (static_cast<uint64_t>(p[3]) << 24) | (static_cast<uint64_t>(p[4]) << 32)
+		   | (static_cast<uint64_t>(p[5]) << 40) | (static_cast<uint64_t>(p[6]) << 48)
+		   | (static_cast<uint64_t>(p[7]) << 56);
+}
+
+
+inline uint32_t Read32(unsigned char const* p)
+{
+	return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) | (static_cast<uint32_t>(p[2]) << 16)
+		   | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+
+inline uint64_t Round(uint64_t acc, uint64_t input)
+{
+	acc += input * PRIME64_2;
+	acc = RotL64(acc, 31);
+	return acc * PRIME64_1;
+}
+
+
+inline uint64_t MergeRound(uint64_t acc, uint64_t val)
+{
+	acc ^= Round(0, val);
+	return acc * PRIME64_1 + PRIME64_4;
+}
+
+
+class CMsgDigestXXH64 : public IMsgDigestContext
+{
+public:
+	CMsgDigestXXH64()
+		: m_acc{PRIME64_1 + PRIME64_2, PRIME64_2, 0, 0 - PRIME64_1}
+		, m_buffer()
+		, m_buffered(0)
+		, m_total(0)
+	{
+	}
+
+	void Update(unsigned char const* data, size_t len) override
+	{
+		m_total += len;
+
+		if (0 < m_buffered)
+		{
+			size_t fill = std::min(len, StripeSize - m_buffered);
+			memcpy(m_buffer + m_buffered, data, fill);
+			m_buffered += fill;
+			data += fill;
+			len -= fill;
+			if (m_buffered < StripeSize)
+				return;
+			ProcessStripe(m_buffer);
+			m_buffered = 0;
+		}
+
+		// Hot loop: keep the accumulators in registers.
+		uint64_t acc0 = m_acc[0];
+		uint64_t acc1 = m_acc[1];
+		uint64_t acc2 = m_acc[2];
+		uint64_t acc3 = m_acc[3];
+		for (; len >= StripeSize; data += StripeSize, len -= StripeSize)
+		{
+			acc0 = Round(acc0, Read64(data));
+			acc1 = Round(acc1, Read64(data + 8));
+			acc2 = Round(acc2, Read64(data + 16));
+			acc3 = Round(acc3, Read64(data + 24));
+		}
+		m_acc[0] = acc0;
+		m_acc[1] = acc1;
+		m_acc[2] = acc2;
+		m_acc[3] = acc3;
+
+		if (0 < len)
+		{
+			memcpy(m_buffer, data, len);
+			m_buffered = len;
+		}
+	}
+
+	wxString Final() override
+	{
+		uint64_t hash = 0;
+		if (m_total >= StripeSize)
+		{
+			hash = RotL64(m_acc[0], 1) + RotL64(m_acc[1], 7) + RotL64(m_acc[2], 12) + RotL64(m_acc[3], 18);
+			for (auto acc : m_acc)
+				hash = MergeRound(hash, acc);
+		}
+		else
+		{
+			hash = PRIME64_5;
+		}
+		hash += m_total;
+
+		unsigned char const* p = m_buffer;
+		size_t len = m_buffered;
+		for (; len >= 8; p += 8, len -= 8)
+		{
+			hash ^= Round(0, Read64(p));
+			hash = RotL64(hash, 27) * PRIME64_1 + PRIME64_4;
+		}
+		if (len >= 4)
+		{
+			hash ^= static_cast<uint64_t>(Read32(p)) * PRIME64_1;
+			hash = RotL64(hash, 23) * PRIME64_2 + PRIME64_3;
+			p += 4;
+			len -= 4;
+		}
+		for (; 0 < len; ++p, --len)
+		{
+			hash ^= static_cast<uint64_t>(*p) * PRIME64_5;
+			hash = RotL64(hash, 11) * PRIME64_1;
+		}
+
+		hash ^= hash >> 33;
+		hash *= PRIME64_2;
+		hash ^= hash >> 29;
+		hash *= PRIME64_3;
+		hash ^= hash >> 32;
+
+		static constexpr char hexDigits[] = "0123456789abcdef";
+		char buf[17];
+		for (int i = 15; i >= 0; --i, hash >>= 4)
+			buf[i] = hexDigits[hash & 0xF];
+		buf[16] = 0;
+		return wxString(buf);
+	}
+
+private:
+	void ProcessStripe(unsigned char const* p)
+	{
+		m_acc[0] = Round(m_acc[0], Read64(p));
+		m_acc[1] = Round(m_acc[1], Read64(p + 8));
+		m_acc[2] = Round(m_acc[2], Read64(p + 16));
+		m_acc[3] = Round(m_acc[3], Read64(p + 24));
+	}
+
+	uint64_t m_acc[4];
+	unsigned char m_buffer[StripeSize];
+	size_t m_buffered;
+	uint64_t m_total;
+};
+} // namespace
+
+
+std::unique_ptr<IMsgDigestContext> ARBMsgDigestCreateXXH64()
+{
+	return std::make_unique<CMsgDigestXXH64>();
+}
+
+} // namespace ARBCommon
+} // namespace dconSoft
@@ -10,6 +10,12 @@
  * @author David Connet
  *
  * Revision History
+ * 2026-10-19 Use zlib's adler32 for parallel EncodeFile.
+ * 2026-10-19 CDecodeContext keeps one zlib inflate stream between blobs.
+ * 2026-10-19 Added size hints, DecodeInto and CDecodeContext.
+ * 2026-10-19 Added compression level, parallel EncodeFile.
+ * 2026-10-19 Stream source -> zlib -> base64 -> sink (and reverse) without
+ *            full size intermediate buffers.
  * 2020-02-29 Removed raw pointers, use vectors.
  * 2014-03-07 Add support for Poco's compression.
  * 2009-09-13 Add support for wxWidgets 2.9, deprecate tstring.
@@ -22,12 +28,15 @@
 #include "ARBCommon/BinaryData.h"
 
 #include "ARBCommon/ARBBase64.h"
+#include "ARBCommon/ParallelFor.h"
 #include "ARBCommon/StringUtil.h"
 
 #include <wx/mstream.h>
 #include <wx/wfstream.h>
 #include <wx/zstream.h>
-#include <fstream>
+#include <zlib.h>
+#include <climits>
+#include <cstring>
 
 #ifdef __WXMSW__
 #include <wx/msw/msvcrt.h>
@@ -39,119 +48,569 @@ namespace dconSoft
 namespace ARBCommon
 {
 
-bool BinaryData::Decode(std::string const& inBase64, std::vector<unsigned char>& outBinData)
+namespace
 {
-	outBinData.clear();
-	if (inBase64.empty())
-		return false;
+// Base64 text decoded per read.
+constexpr size_t DecodeChunkChars = 16 * 1024;
+// Minimum growth of the output while inflating.
+constexpr size_t InflateBlockSize = 64 * 1024;
+// Parallel deflate: input per block. Blocks are compressed independently
+// (no shared dictionary), so smaller blocks cost compression ratio.
+constexpr size_t DeflateBlockSize = 1024 * 1024;
 
-	bool bOk = false;
-	std::vector<unsigned char> pData;
-	if (ARBBase64::Decode(inBase64, pData))
+
+// Compressed data -> base64 text.
+class CBase64OutputStream : public wxOutputStream
+{
+public:
+	explicit CBase64OutputStream(std::string& outBase64)
+		: m_encoder([&outBase64](void const* data, size_t len) {
+			outBase64.append(static_cast<char const*>(data), len);
+			return true;
+		})
+	{
+	}
+
+	bool Finish()
+	{
+		return m_encoder.Finish();
+	}
+
+protected:
+	size_t OnSysWrite(void const* buffer, size_t size) override
+	{
+		if (!m_encoder.Write(buffer, size))
+		{
+			m_lasterror = wxSTREAM_WRITE_ERROR;
+			return 0;
+		}
+		return size;
+	}
+
+private:
+	ARBBase64::CEncoder m_encoder;
+};
+
+
+// Base64 text -> compressed data.
+class CBase64InputStream : public wxInputStream
+{
+public:
+	explicit CBase64InputStream(std::string_view inBase64)
+		: m_text(inBase64)
+		, m_pos(0)
+		, m_pending()
+		, m_pendingPos(0)
+		, m_decoder([this](void const* data, size_t len) {
+			m_pending.insert(
+				m_pending.end(),
+				static_cast<unsigned char const*>(data),
+				static_cast<unsigned char const*>(data) + len);
+			return true;
+		})
+		, m_bValid(true)
+		, m_bFinished(false)
+	{
+	}
+
+	// Decode (and discard) whatever zlib didn't need, to catch invalid text.
+	bool Drain()
+	{
+		while (m_bValid && !m_bFinished)
+		{
+			m_pendingPos = m_pending.size();
+			Fill();
+		}
+		return m_bValid;
+	}
+
+protected:
+	size_t OnSysRead(void* buffer, size_t size) override
+	{
+		if (m_pendingPos == m_pending.size() && !Fill())
+			return 0;
+		size = std::min(size, m_pending.size() - m_pendingPos);
+		memcpy(buffer, m_pending.data() + m_pendingPos, size);
+		m_pendingPos += size;
+		return size;
+	}
+
+private:
+	bool Fill()
+	{
+		m_pending.clear();
+		m_pendingPos = 0;
+		while (m_pending.empty())
+		{
+			if (m_pos < m_text.size())
+			{
+				size_t len = std::min(m_text.size() - m_pos, DecodeChunkChars);
+				m_bValid = m_decoder.Write(m_text.data() + m_pos, len);
+				m_pos += len;
+			}
+			else if (!m_bFinished)
+			{
+				m_bFinished = true;
+				m_bValid = m_decoder.Finish();
+			}
+			else
+			{
+				m_lasterror = wxSTREAM_EOF;
+				return false;
+			}
+			if (!m_bValid)
+			{
+				m_bFinished = true;
+				m_lasterror = wxSTREAM_READ_ERROR;
+				return false;
+			}
+		}
+		return true;
+	}
+
+	std::string_view m_text;
+	size_t m_pos;
+	std::vector<unsigned char> m_pending;
+	size_t m_pendingPos;
+	ARBBase64::CDecoder m_decoder;
+	bool m_bValid;
+	bool m_bFinished;
+};
+
+
+// Collects a compressed block.
+class CBlockOutputStream : public wxOutputStream
+{
+public:
+	std::vector<unsigned char> m_data;
+
+protected:
+	size_t OnSysWrite(void const* buffer, size_t size) override
+	{
+		m_data.insert(
+			m_data.end(),
+			static_cast<unsigned char const*>(buffer),
+			static_cast<unsigned char const*>(buffer) + size);
+		return size;
+	}
+};
+
+
+/**
+ * Compress one block as raw deflate data that can be concatenated with
+ * other blocks: the output ends on a byte boundary and is not marked final.
+ */
+std::vector<unsigned char> DeflateBlock(std::vector<unsigned char> const& inData, int level)
+{
+	CBlockOutputStream output;
+	size_t size = 0;
 	{
-		wxMemoryOutputStream output;
+		wxZlibOutputStream strm(output, level, wxZLIB_NO_HEADER);
+		strm.Write(inData.data(), inData.size());
+		// Full flush: byte aligned, not final, no back references into
+		// the next block.
+		strm.Sync();
+		size = output.m_data.size();
+	}
+	// Closing the stream added a final empty block: drop it.
+	output.m_data.resize(size);
+	return std::move(output.m_data);
+}
+
+
+bool EncodeFileParallel(wxFFile& file, size_t inLen, int level, size_t nThreads, std::string& outBase64)
+{
+	size_t estimate = (inLen + inLen / 1000 + 64) / 3 * 4;
+	outBase64.reserve(estimate + estimate / 76 + 8);
+	CBase64OutputStream output(outBase64);
+
+	// zlib header: deflate, 32K window, level hint, check bits.
+	int flevel = 2;
+	if (0 <= level && level <= 1)
+		flevel = 0;
+	else if (2 <= level && level <= 5)
+		flevel = 1;
+	else if (7 <= level)
+		flevel = 3;
+	unsigned char header[2] = {0x78, static_cast<unsigned char>(flevel << 6)};
+	header[1] = static_cast<unsigned char>(header[1] + 31 - (header[0] * 256 + header[1]) % 31);
+	output.Write(header, sizeof(header));
+
+	uLong adler = 1;
+	std::vector<std::vector<unsigned char>> blocks(nThreads);
+	std::vector<std::vector<unsigned char>> compressed(nThreads);
+	std::vector<uLong> adlers(nThreads);
+	bool bEof = false;
+	while (!bEof && output.IsOk())
+	{
+		size_t nBlocks = 0;
+		for (; !bEof && nBlocks < nThreads; ++nBlocks)
 		{
-			wxZlibInputStream strm(new wxMemoryInputStream(pData.data(), pData.size()), wxZLIB_ZLIB);
-			output.Write(strm);
-			output.Close();
+			blocks[nBlocks].resize(DeflateBlockSize);
+			size_t len = file.Read(blocks[nBlocks].data(), DeflateBlockSize);
+			blocks[nBlocks].resize(len);
+			if (len < DeflateBlockSize)
+			{
+				if (file.Error())
+					return false;
+				bEof = true;
+				if (0 == len)
+					break;
+			}
+		}
+		ParallelFor(nBlocks, nThreads, [&](size_t idx) {
+			compressed[idx] = DeflateBlock(blocks[idx], level);
+			// Blocks are DeflateBlockSize at most, so the length fits in uInt.
+			adlers[idx] = adler32(1, blocks[idx].data(), static_cast<uInt>(blocks[idx].size()));
+		});
+		for (size_t idx = 0; idx < nBlocks; ++idx)
+		{
+			output.Write(compressed[idx].data(), compressed[idx].size());
+			adler = adler32_combine(adler, adlers[idx], static_cast<z_off_t>(blocks[idx].size()));
 		}
-		size_t outBytes = output.GetSize();
-		outBinData = std::vector<unsigned char>(outBytes);
-		output.CopyTo(outBinData.data(), outBytes);
-		bOk = true;
 	}
 
+	// Final empty (fixed huffman) block, then the adler32 (big endian).
+	unsigned char trailer[6] = {
+		0x03,
+		0x00,
+		static_cast<unsigned char>(adler >> 24),
+		static_cast<unsigned char>(adler >> 16),
+		static_cast<unsigned char>(adler >> 8),
+		static_cast<unsigned char>(adler)};
+	output.Write(trailer, sizeof(trailer));
+	bool bOk = output.IsOk() && output.Finish();
+	if (outBase64.capacity() > 2 * outBase64.size())
+		outBase64.shrink_to_fit();
 	return bOk;
 }
 
 
-bool BinaryData::Encode(std::vector<unsigned char> const& inBinData, std::string& outBase64)
+// Works with std::vector<unsigned char> and std::string.
+template <typename T> bool Inflate(wxInputStream& strm, T& outData, size_t inSizeHint)
 {
-	outBase64.clear();
-	if (inBinData.empty())
+	size_t size = 0;
+	outData.resize(0 < inSizeHint ? inSizeHint : InflateBlockSize);
+	for (;;)
+	{
+		if (size == outData.size())
+		{
+			// Full. Check for more before growing: the hint may be exact.
+			unsigned char probe[256];
+			strm.Read(probe, sizeof(probe));
+			if (0 == strm.LastRead())
+				break;
+			outData.resize(std::max(size + InflateBlockSize, outData.size() * 2));
+			memcpy(&outData[size], probe, strm.LastRead());
+			size += strm.LastRead();
+		}
+		strm.Read(&outData[size], outData.size() - size);
+		if (0 == strm.LastRead())
+			break;
+		size += strm.LastRead();
+	}
+	outData.resize(size);
+	// Corrupt or truncated zlib data.
+	return wxSTREAM_READ_ERROR != strm.GetLastError();
+}
+
+
+bool InflateInto(wxInputStream& strm, unsigned char* outBuffer, size_t inBufferSize, size_t& outSize)
+{
+	strm.Read(outBuffer, inBufferSize);
+	outSize = strm.LastRead();
+	if (outSize == inBufferSize)
+	{
+		unsigned char probe;
+		strm.Read(&probe, 1);
+		if (0 < strm.LastRead())
+			return false;
+	}
+	return wxSTREAM_READ_ERROR != strm.GetLastError();
+}
+
+
+template <typename T> bool DecodeTo(std::string_view inBase64, T& outData, size_t inSizeHint)
+{
+	if (inBase64.empty())
 		return false;
 
+	CBase64InputStream input(inBase64);
 	bool bOk = false;
-	size_t nData = 0;
-
-	wxMemoryOutputStream output;
 	{
-		wxZlibOutputStream strm(output);
-		strm.Write(inBinData.data(), inBinData.size());
-		strm.Close();
+		wxZlibInputStream strm(input, wxZLIB_ZLIB);
+		bOk = Inflate(strm, outData, inSizeHint);
 	}
-	nData = output.GetSize();
-	auto pData = std::vector<unsigned char>(nData);
-	output.CopyTo(pData.data(), nData);
+	return input.Drain() && bOk;
+}
 
-	if (!pData.empty())
+
+bool EncodeStream(wxInputStream* inData, void const* inBuffer, size_t inLen, int level, std::string& outBase64)
+{
+	// Size for incompressible data (plus zlib overhead and line breaks) so
+	// the output doesn't keep reallocating. Trim if it compressed well.
+	size_t estimate = (inLen + inLen / 1000 + 64) / 3 * 4;
+	outBase64.reserve(estimate + estimate / 76 + 8);
+	CBase64OutputStream output(outBase64);
 	{
-		bOk = ARBBase64::Encode(pData, outBase64);
+		wxZlibOutputStream strm(output, level);
+		if (inData)
+			strm.Write(*inData);
+		else
+			strm.Write(inBuffer, inLen);
+		strm.Close();
 	}
+	bool bOk = output.Finish();
+	if (outBase64.capacity() > 2 * outBase64.size())
+		outBase64.shrink_to_fit();
+	return bOk;
+}
+} // namespace
 
+
+bool BinaryData::Decode(std::string_view inBase64, std::vector<unsigned char>& outBinData, size_t inSizeHint)
+{
+	std::vector<unsigned char> data;
+	bool bOk = DecodeTo(inBase64, data, inSizeHint);
+	if (bOk)
+		outBinData = std::move(data);
+	else
+		outBinData.clear();
 	return bOk;
 }
 
 
-bool BinaryData::EncodeFile(wxString const& inFileName, std::string& outBase64)
+bool BinaryData::DecodeInto(std::string_view inBase64, unsigned char* outBuffer, size_t inBufferSize, size_t& outSize)
 {
-	outBase64.clear();
+	outSize = 0;
+	if (inBase64.empty() || (!outBuffer && 0 < inBufferSize))
+		return false;
 
+	CBase64InputStream input(inBase64);
 	bool bOk = false;
-	size_t nData = 0;
+	{
+		wxZlibInputStream strm(input, wxZLIB_ZLIB);
+		bOk = InflateInto(strm, outBuffer, inBufferSize, outSize);
+	}
+	return bOk && input.Drain();
+}
 
-	wxFFile file;
-	if (!file.Open(inFileName, L"rb"))
-		return false;
 
-	wxMemoryOutputStream output;
+// wxZlibInputStream can't be reused (every stream runs inflateInit and
+// allocates its own buffers), so the context drives zlib directly.
+struct BinaryData::CDecodeContext::CInflater
+{
+	z_stream strm;
+	bool bInit;
+
+	CInflater()
+		: strm()
+		, bInit(false)
 	{
-		wxZlibOutputStream strm(output);
-		wxFFileInputStream instrm(file);
-		strm.Write(instrm);
-		strm.Close();
+		bInit = Z_OK == inflateInit(&strm);
 	}
-	nData = output.GetSize();
-	auto pData = std::vector<unsigned char>(nData);
-	output.CopyTo(pData.data(), nData);
 
-	if (!pData.empty())
+	~CInflater()
 	{
-		std::string tmp;
-		bOk = ARBBase64::Encode(pData, tmp);
-		outBase64 = tmp;
+		if (bInit)
+			inflateEnd(&strm);
 	}
 
-	return bOk;
+	bool Start(std::vector<unsigned char>& inCompressed)
+	{
+		if (!bInit || Z_OK != inflateReset(&strm))
+			return false;
+		// Blobs this size are better handled by the streaming functions.
+		if (UINT_MAX < inCompressed.size())
+			return false;
+		strm.next_in = inCompressed.data();
+		strm.avail_in = static_cast<uInt>(inCompressed.size());
+		return true;
+	}
+
+	/**
+	 * Inflate into a buffer.
+	 * @return Z_STREAM_END (done), Z_OK (buffer full) or an error.
+	 */
+	int Inflate(unsigned char* outBuffer, size_t inSize, size_t& outWritten)
+	{
+		strm.next_out = outBuffer;
+		strm.avail_out = static_cast<uInt>(std::min<size_t>(inSize, UINT_MAX));
+		uInt avail = strm.avail_out;
+		int rc = inflate(&strm, Z_NO_FLUSH);
+		outWritten = avail - strm.avail_out;
+		if (Z_BUF_ERROR == rc && 0 == strm.avail_out)
+			rc = Z_OK;
+		// No progress possible: the data is truncated.
+		else if (Z_OK == rc && 0 < strm.avail_out)
+			rc = Z_DATA_ERROR;
+		return rc;
+	}
+};
+
+
+BinaryData::CDecodeContext::CDecodeContext()
+	: m_inflater(new CInflater())
+	, m_compressed()
+{
 }
 
 
-bool BinaryData::DecodeString(std::string const& inBase64, std::string& outData)
+BinaryData::CDecodeContext::~CDecodeContext()
 {
-	if (inBase64.empty())
+}
+
+
+bool BinaryData::CDecodeContext::Decode(
+	std::string_view inBase64,
+	std::vector<unsigned char>& outBinData,
+	size_t inSizeHint)
+{
+	// Unlike the free function, decode the base64 up front: the buffer is
+	// reused, so this costs nothing once it has grown.
+	if (!ARBBase64::Decode(inBase64, m_compressed) || !m_inflater->Start(m_compressed))
 	{
-		outData.clear();
+		outBinData.clear();
 		return false;
 	}
-	std::vector<unsigned char> data;
-	if (!BinaryData::Decode(inBase64, data))
-		return false;
-	outData = std::string(data.begin(), data.end());
+	size_t size = 0;
+	outBinData.resize(0 < inSizeHint ? inSizeHint : InflateBlockSize);
+	for (;;)
+	{
+		size_t written = 0;
+		int rc = Z_OK;
+		if (size == outBinData.size())
+		{
+			// Full. Check for more before growing: the hint may be exact.
+			unsigned char probe[256];
+			rc = m_inflater->Inflate(probe, sizeof(probe), written);
+			if (0 < written)
+			{
+				outBinData.resize(std::max(size + InflateBlockSize, outBinData.size() * 2));
+				memcpy(&outBinData[size], probe, written);
+			}
+		}
+		else
+			rc = m_inflater->Inflate(&outBinData[size], outBinData.size() - size, written);
+		size += written;
+		if (Z_STREAM_END == rc)
+			break;
+		if (Z_OK != rc)
+		{
+			outBinData.clear();
+			return false;
+		}
+	}
+	outBinData.resize(size);
 	return true;
 }
 
 
-bool BinaryData::EncodeString(std::string const& inData, std::string& outBase64)
+bool BinaryData::CDecodeContext::DecodeInto(
+	std::string_view inBase64,
+	unsigned char* outBuffer,
+	size_t inBufferSize,
+	size_t& outSize)
+{
+	outSize = 0;
+	if ((!outBuffer && 0 < inBufferSize) || !ARBBase64::Decode(inBase64, m_compressed)
+		|| !m_inflater->Start(m_compressed))
+		return false;
+	size_t written = 0;
+	int rc = Z_OK;
+	while (Z_OK == rc && outSize < inBufferSize)
+	{
+		rc = m_inflater->Inflate(outBuffer + outSize, inBufferSize - outSize, written);
+		outSize += written;
+	}
+	if (Z_OK == rc)
+	{
+		// Full: it only fits if there is nothing more.
+		unsigned char probe;
+		rc = m_inflater->Inflate(&probe, 1, written);
+		if (0 < written)
+			return false;
+	}
+	return Z_STREAM_END == rc;
+}
+
+
+bool BinaryData::Encode(std::vector<unsigned char> const& inBinData, std::string& outBase64, int level)
+{
+	return Encode(inBinData.data(), inBinData.size(), outBase64, level);
+}
+
+
+bool BinaryData::Encode(void const* inData, size_t inLen, std::string& outBase64, int level)
+{
+	if (!inData || 0 == inLen)
+	{
+		outBase64.clear();
+		return false;
+	}
+	// Input may be in the output.
+	std::string base64;
+	bool bOk = EncodeStream(nullptr, inData, inLen, level, base64);
+	if (bOk)
+		outBase64 = std::move(base64);
+	else
+		outBase64.clear();
+	return bOk;
+}
+
+
+bool BinaryData::EncodeFile(wxString const& inFileName, std::string& outBase64, int level, size_t nThreads)
 {
 	outBase64.clear();
-	if (inData.empty())
+
+	wxFFile file;
+	if (!file.Open(inFileName, L"rb"))
 		return false;
+
+	auto length = file.Length();
+	size_t inLen = 0 < length ? static_cast<size_t>(length) : 0;
+	if (0 == nThreads)
+		nThreads = GetDefaultThreadCount();
+	nThreads = std::min(nThreads, (inLen + DeflateBlockSize - 1) / DeflateBlockSize);
+
+	bool bOk = false;
+	if (1 < nThreads)
+	{
+		bOk = EncodeFileParallel(file, inLen, level, nThreads, outBase64);
+	}
+	else
+	{
+		wxFFileInputStream instrm(file);
+		bOk = EncodeStream(&instrm, nullptr, inLen, level, outBase64);
+	}
+	if (!bOk)
+	{
+		outBase64.clear();
+		return false;
+	}
+	return true;
+}
+
+
+bool BinaryData::DecodeString(std::string_view inBase64, std::string& outData)
+{
+	// Input may be in the output.
+	std::string data;
+	bool bOk = DecodeTo(inBase64, data, 0);
+	if (bOk)
+		outData = std::move(data);
+	else if (inBase64.empty())
+		outData.clear();
+	return bOk;
+}
+
+
+bool BinaryData::EncodeString(std::string_view inData, std::string& outBase64)
+{
 	// Do not include the null terminator. Otherwise decoding includes it into
 	// the output string - which when streamed, then includes the null. Which
 	// in an ostringstream, terminates the string on output of the stream.
-	// TODO: Better conversion
-	std::vector<unsigned char> data(inData.begin(), inData.end());
-	return BinaryData::Encode(data, outBase64);
+	return Encode(inData.data(), inData.size(), outBase64);
 }
 
 } // namespace ARBCommon
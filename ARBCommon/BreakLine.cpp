@@ -10,6 +10,9 @@
  * @author David Connet
  *
  * Revision History
+ * 2026-10-19 Added string_view BreakLine.
+ * 2026-10-19 WriteCSV/WriteCSVField: Escape in a single pass into the output.
+ * 2026-10-19 ReadCSV: Walk the record by index and copy runs of text.
  * 2012-07-25 Fix a CSV read problem with multiline continuation data.
  * 2012-04-10 Based on wx-group thread, use std::string for internal use
  * 2010-10-30 Moved BreakLine from Globals.cpp, added CSV routines.
@@ -58,6 +61,21 @@ size_t BreakLine(wchar_t inSep, wxString const& inStr, std::vector<wxString>& ou
 }
 
 
+size_t BreakLine(
+	wchar_t inSep,
+	std::wstring_view inStr,
+	std::vector<std::wstring_view>& outFields,
+	bool inRemoveEmpties)
+{
+	outFields.clear();
+	return ForEachField(inSep, inStr, [&outFields, inRemoveEmpties](std::wstring_view field) {
+		if (!(inRemoveEmpties && field.empty()))
+			outFields.push_back(field);
+		return true;
+	});
+}
+
+
 /* Grammar copied from RFC4180
  *
  * The ABNF grammar [2] appears as follows:
@@ -92,91 +110,75 @@ ReadStatus ReadCSV(
 		ioFields[ioFields.size() - 1] += newLine;
 		status = ReadStatus::NeedMore;
 	}
+	// Walk the record with an index and copy whole runs between the special
+	// characters (instead of re-copying the rest of the record per field and
+	// appending one char at a time).
+	size_t const length = inRecord.length();
+	size_t pos = 0;
 	bool bAddEmpty = false;
-	while (!inRecord.empty())
+	while (pos < length)
 	{
 		wxString str;
-		wxString ::size_type posSep = inRecord.find(inSep);
-		if (bContinuation || L'"' == inRecord[0])
+		if (bContinuation || L'"' == inRecord[pos])
 		{
-			wxString ::size_type posQuote = inRecord.find(L'"', bContinuation ? 0 : 1);
-			if (wxString ::npos == posQuote)
+			size_t start = bContinuation ? pos : pos + 1;
+			size_t posQuote = inRecord.find(L'"', start);
+			if (wxString::npos == posQuote)
 			{
-				if (bContinuation)
-					str = inRecord;
-				else
-					str = inRecord.substr(1);
-				inRecord.clear();
+				str = inRecord.substr(start);
+				pos = length;
 				status = ReadStatus::NeedMore;
 			}
 			else
 			{
-				wxString data;
-				wxString::iterator iStr = inRecord.begin();
-				if (!bContinuation)
-					++iStr;
-				bool bInQuote = true;
-				for (; iStr != inRecord.end(); ++iStr)
+				pos = start;
+				while (pos < length)
 				{
-					if (!bInQuote && *iStr == inSep)
+					posQuote = inRecord.find(L'"', pos);
+					if (wxString::npos == posQuote)
 					{
-						++iStr;
+						str.append(inRecord, pos, wxString::npos);
+						pos = length;
 						break;
 					}
-					else if (*iStr == L'"')
+					str.append(inRecord, pos, posQuote - pos);
+					pos = posQuote + 1;
+					// Closing quote at the end of the record.
+					if (pos == length)
+						break;
+					if (L'"' == inRecord[pos])
 					{
-						// This is the last char.
-						if (iStr + 1 == inRecord.end())
-						{
-							if (!bInQuote)
-								return ReadStatus::Error;
-							else
-								bInQuote = false;
-						}
-						else
-						{
-							if (*(iStr + 1) == L'"')
-							{
-								data += *iStr;
-								++iStr;
-							}
-							else if (*(iStr + 1) == inSep)
-								bInQuote = false;
-							else
-							{
-								if (bInQuote)
-									return ReadStatus::Error;
-								data += *iStr;
-							}
-						}
+						str += L'"';
+						++pos;
+					}
+					else if (inSep == inRecord[pos])
+					{
+						++pos;
+						break;
 					}
 					else
-						data += *iStr;
+						return ReadStatus::Error;
 				}
-				str = data;
-				if (iStr == inRecord.end())
-					inRecord.clear();
-				else
-					inRecord = wxString(iStr, inRecord.end());
 			}
 		}
 		else
 		{
-			if (wxString ::npos == posSep)
+			size_t posSep = inRecord.find(inSep, pos);
+			if (wxString::npos == posSep)
 			{
-				str = inRecord;
-				inRecord.clear();
+				str = inRecord.substr(pos);
+				pos = length;
 			}
 			else
 			{
-				str = inRecord.substr(0, posSep);
-				inRecord = inRecord.substr(posSep + 1);
-				if (inRecord.empty())
+				str = inRecord.substr(pos, posSep - pos);
+				pos = posSep + 1;
+				if (pos == length)
 					bAddEmpty = true;
 			}
 			// If there is a quote in the string,
 			// the field itself must be quoted.
-			if (wxString ::npos != str.find(L'"'))
+			if (wxString::npos != str.find(L'"'))
 				return ReadStatus::Error;
 		}
 		if (bContinuation && 0 < ioFields.size())
@@ -193,13 +195,12 @@ ReadStatus ReadCSV(
 
 wxString WriteCSV(wchar_t inSep, std::vector<wxString> const& inFields, bool includeQuote)
 {
-	size_t fld = 0;
 	wxString val;
-	for (std::vector<wxString>::const_iterator i = inFields.begin(); i != inFields.end(); ++i, ++fld)
+	for (size_t fld = 0; fld < inFields.size(); ++fld)
 	{
 		if (0 < fld)
 			val << inSep;
-		val << WriteCSVField(inSep, *i, includeQuote);
+		WriteCSVField(inSep, inFields[fld], includeQuote, val);
 	}
 	return val;
 }
@@ -208,36 +209,36 @@ wxString WriteCSV(wchar_t inSep, std::vector<wxString> const& inFields, bool inc
 wxString WriteCSVField(wchar_t inSep, wxString const& inField, bool includeQuote)
 {
 	wxString val;
-	if (wxString ::npos != inField.find(L'"') || wxString ::npos != inField.find(L'\n')
-		|| wxString ::npos != inField.find(inSep))
+	WriteCSVField(inSep, inField, includeQuote, val);
+	return val;
+}
+
+
+void WriteCSVField(wchar_t inSep, wxString const& inField, bool includeQuote, wxString& ioOutput)
+{
+	if (wxString::npos != inField.find(L'"') || wxString::npos != inField.find(L'\n')
+		|| wxString::npos != inField.find(inSep))
 	{
-		wxString str(inField);
-		val << L"\"";
-		while (!str.empty())
+		// Single pass: copy runs up to and including each quote, then double it.
+		ioOutput << L'"';
+		size_t pos = 0;
+		for (size_t posQuote = inField.find(L'"'); wxString::npos != posQuote; posQuote = inField.find(L'"', pos))
 		{
-			wxString ::size_type pos = str.find(L'"');
-			if (wxString ::npos == pos)
-			{
-				val << str;
-				str.clear();
-			}
-			else
-			{
-				val << str.substr(0, pos) << L"\"\"";
-				str = str.substr(pos + 1);
-			}
+			ioOutput.append(inField, pos, posQuote - pos + 1);
+			ioOutput << L'"';
+			pos = posQuote + 1;
 		}
-		val << L"\"";
+		ioOutput.append(inField, pos, wxString::npos);
+		ioOutput << L'"';
 	}
 	else if (includeQuote)
 	{
-		val << L"\"" << inField << L"\"";
+		ioOutput << L'"' << inField << L'"';
 	}
 	else
 	{
-		val << inField;
+		ioOutput << inField;
 	}
-	return val;
 }
 
 } // namespace ARBCommon
@@ -0,0 +1,559 @@
+/*
+ * Copyright (c) David Connet. All Rights Reserved.
+ *
+ * License: See License.txt
+ */
+
+/**
+ * @file
+ * @brief Streaming CSV reader
+ * @author David Connet
+ *
+ * Fields are located with a vectorized scan (SSE2, which every x64 CPU has)
+ * for the few characters that matter: separator, quote and newline. The
+ * text between them is never looked at one character at a time.
+ *
+ * Revision History
+ * 2026-10-19 Report stream failures instead of treating them as the end.
+ * 2026-10-19 Added multi-threaded ReadCsvRows/ReadCsvFile.
+ * 2026-10-19 Scan 16 bytes at a time for structural characters.
+ * 2026-10-19 Created
+ */
+
+#include "stdafx.h"
+#include "ARBCommon/CsvReader.h"
+
+#include "ARBCommon/ParallelFor.h"
+#include <wx/ffile.h>
+#include <cstring>
+#include <iterator>
+#include <thread>
+
+#if defined(_M_X64) || defined(__x86_64__) || (defined(_M_IX86_FP) && 2 <= _M_IX86_FP) || defined(__SSE2__)
+#define ARB_CSV_SSE2 1
+#include <emmintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#else
+#define ARB_CSV_SSE2 0
+#endif
+
+#if defined(__WXMSW__)
+#include <wx/msw/msvcrt.h>
+#endif
+
+
+namespace dconSoft
+{
+namespace ARBCommon
+{
+
+namespace
+{
+// Stream data read at once. A row larger than this grows the buffer.
+constexpr size_t ChunkSize = 64 * 1024;
+
+
+#if ARB_CSV_SSE2
+inline unsigned int LowestBit(unsigned int mask)
+{
+#if defined(_MSC_VER)
+	unsigned long idx;
+	_BitScanForward(&idx, mask);
+	return idx;
+#else
+	return static_cast<unsigned int>(__builtin_ctz(mask));
+#endif
+}
+#endif
+
+
+// First of c1, c2 or c3 in [p, end), or end.
+inline char const* FindAny(char const* p, char const* end, char c1, char c2, char c3)
+{
+#if ARB_CSV_SSE2
+	__m128i const v1 = _mm_set1_epi8(c1);
+	__m128i const v2 = _mm_set1_epi8(c2);
+	__m128i const v3 = _mm_set1_epi8(c3);
+	for (; 16 <= end - p; p += 16)
+	{
+		__m128i chunk = _mm_loadu_si128(reinterpret_cast<__m128i const*>(p));
+		__m128i match = _mm_or_si128(
+			_mm_or_si128(_mm_cmpeq_epi8(chunk, v1), _mm_cmpeq_epi8(chunk, v2)),
+			_mm_cmpeq_epi8(chunk, v3));
+		unsigned int mask = static_cast<unsigned int>(_mm_movemask_epi8(match));
+		if (mask)
+			return p + LowestBit(mask);
+	}
+#endif
+	for (; p != end; ++p)
+	{
+		if (c1 == *p || c2 == *p || c3 == *p)
+			break;
+	}
+	return p;
+}
+
+
+// Parallel import: target number of chunks per thread (so threads that
+// finish early can pick up more work) and the smallest chunk worth a thread.
+constexpr size_t ChunksPerThread = 8;
+constexpr size_t MinChunkSize = 1024 * 1024;
+
+
+// Pass 1: what a chunk looks like assuming it starts outside (0) or inside
+// (1) a quoted field.
+struct CsvChunkInfo
+{
+	size_t quotes = 0;
+	size_t lines = 0;
+	size_t firstNewline[2] = {std::string_view::npos, std::string_view::npos};
+	size_t linesBefore[2] = {0, 0};
+};
+
+
+// Pass 2: a run of whole records.
+struct CsvRange
+{
+	size_t begin = 0;
+	size_t end = 0;
+	size_t line = 1;
+	bool bError = false;
+	size_t errorLine = 0;
+	std::vector<std::vector<std::string>> rows;
+};
+
+
+CsvChunkInfo ScanChunk(char const* begin, char const* end)
+{
+	// A quote toggles the state. Doubled quotes toggle it twice and quotes
+	// anywhere else are errors the parser reports, so parity is enough.
+	CsvChunkInfo info;
+	for (char const* p = FindAny(begin, end, '"', '\n', '\n'); p != end; p = FindAny(p + 1, end, '"', '\n', '\n'))
+	{
+		if ('"' == *p)
+			++info.quotes;
+		else
+		{
+			size_t parity = info.quotes & 1;
+			if (std::string_view::npos == info.firstNewline[parity])
+			{
+				info.firstNewline[parity] = static_cast<size_t>(p - begin);
+				info.linesBefore[parity] = info.lines;
+			}
+			++info.lines;
+		}
+	}
+	return info;
+}
+
+
+void ParseRange(std::string_view inData, char inSep, CsvRange& range)
+{
+	CsvReader reader(inData.substr(range.begin, range.end - range.begin), inSep);
+	while (reader.ReadRow())
+	{
+		auto const& fields = reader.Fields();
+		range.rows.emplace_back(fields.begin(), fields.end());
+	}
+	if (reader.IsError())
+	{
+		range.bError = true;
+		range.errorLine = range.line + reader.GetLineNumber() - 1;
+	}
+}
+} // namespace
+
+
+CsvReader::CsvReader(std::istream& inStream, char inSep)
+	: m_stream(&inStream)
+	, m_sep(inSep)
+	, m_buffer(ChunkSize)
+	, m_data(m_buffer.data())
+	, m_pos(0)
+	, m_end(0)
+	, m_bEof(false)
+	, m_bError(false)
+	, m_bReadError(false)
+	, m_line(0)
+	, m_nextLine(1)
+	, m_scratch()
+	, m_spans()
+	, m_fields()
+{
+	Fill();
+	SkipBOM();
+}
+
+
+CsvReader::CsvReader(std::string_view inData, char inSep)
+	: m_stream(nullptr)
+	, m_sep(inSep)
+	, m_buffer()
+	, m_data(inData.data())
+	, m_pos(0)
+	, m_end(inData.size())
+	, m_bEof(true)
+	, m_bError(false)
+	, m_bReadError(false)
+	, m_line(0)
+	, m_nextLine(1)
+	, m_scratch()
+	, m_spans()
+	, m_fields()
+{
+	SkipBOM();
+}
+
+
+CsvReader::~CsvReader()
+{
+}
+
+
+bool CsvReader::ReadRow()
+{
+	m_fields.clear();
+	if (m_bError)
+		return false;
+
+	for (;;)
+	{
+		if (m_pos == m_end)
+		{
+			if (m_bEof)
+				return false;
+			if (!Fill())
+				return false;
+			continue;
+		}
+		char const* pos = m_data + m_pos;
+		size_t lines = 0;
+		ParseStatus status = ParseRow(pos, m_data + m_end, lines);
+		if (ParseStatus::NeedMore == status)
+		{
+			// Parse the row again once the rest of it is buffered.
+			if (!Fill())
+				return false;
+			continue;
+		}
+		m_line = m_nextLine;
+		if (ParseStatus::Error == status)
+		{
+			m_bError = true;
+			return false;
+		}
+		m_pos = static_cast<size_t>(pos - m_data);
+		m_nextLine += lines;
+		break;
+	}
+
+	for (auto const& span : m_spans)
+		m_fields.emplace_back(span.ptr ? span.ptr : m_scratch.data() + span.offset, span.length);
+	return true;
+}
+
+
+void CsvReader::SkipBOM()
+{
+	if (3 <= m_end - m_pos && 0 == memcmp(m_data + m_pos, "\xEF\xBB\xBF", 3))
+		m_pos += 3;
+}
+
+
+/* Grammar: see RFC4180 in BreakLine.cpp.
+ * This is more lenient in that CRLF and LF both end a record and TEXTDATA is
+ * anything other than a separator, quote or newline.
+ */
+CsvReader::ParseStatus CsvReader::ParseRow(char const*& ioPos, char const* end, size_t& outLines)
+{
+	m_spans.clear();
+	m_scratch.clear();
+
+	char const* p = ioPos;
+	size_t lines = 0;
+	bool bAfterSep = false;
+	for (;;)
+	{
+		if (p == end)
+		{
+			if (!m_bEof)
+				return ParseStatus::NeedMore;
+			if (bAfterSep)
+				m_spans.push_back({p, 0, 0});
+			break;
+		}
+
+		if ('"' == *p)
+		{
+			++p;
+			char const* seg = p;
+			size_t offset = m_scratch.size();
+			bool bCopied = false;
+			for (;;)
+			{
+				p = FindAny(p, end, '"', '\r', '\n');
+				if (p == end)
+					return m_bEof ? ParseStatus::Error : ParseStatus::NeedMore;
+				if ('\n' == *p)
+				{
+					++lines;
+					++p;
+				}
+				else if ('\r' == *p)
+				{
+					if (p + 1 == end)
+						return m_bEof ? ParseStatus::Error : ParseStatus::NeedMore;
+					if ('\n' == p[1])
+					{
+						// CRLF -> LF
+						m_scratch.append(seg, p);
+						bCopied = true;
+						seg = p + 1;
+						++lines;
+						p += 2;
+					}
+					else
+						++p;
+				}
+				else if (p + 1 == end && !m_bEof)
+				{
+					return ParseStatus::NeedMore;
+				}
+				else if (p + 1 != end && '"' == p[1])
+				{
+					// Keep one of the doubled quotes.
+					m_scratch.append(seg, p + 1);
+					bCopied = true;
+					p += 2;
+					seg = p;
+				}
+				else
+					break;
+			}
+			if (bCopied)
+			{
+				m_scratch.append(seg, p);
+				m_spans.push_back({nullptr, offset, m_scratch.size() - offset});
+			}
+			else
+				m_spans.push_back({seg, 0, static_cast<size_t>(p - seg)});
+			++p;
+		}
+		else
+		{
+			char const* start = p;
+			p = FindAny(p, end, m_sep, '\n', '"');
+			if (p == end && !m_bEof)
+				return ParseStatus::NeedMore;
+			// If there is a quote in the field, the field itself must be quoted.
+			if (p != end && '"' == *p)
+				return ParseStatus::Error;
+			char const* fieldEnd = p;
+			if (p != end && '\n' == *p && start < fieldEnd && '\r' == fieldEnd[-1])
+				--fieldEnd;
+			// An empty line has no fields.
+			if (bAfterSep || start != fieldEnd || (p != end && m_sep == *p))
+				m_spans.push_back({start, 0, static_cast<size_t>(fieldEnd - start)});
+		}
+
+		// A field is followed by a separator, the end of the record or the end
+		// of the data.
+		if (p == end)
+		{
+			if (!m_bEof)
+				return ParseStatus::NeedMore;
+			break;
+		}
+		if (m_sep == *p)
+		{
+			++p;
+			bAfterSep = true;
+			continue;
+		}
+		if ('\r' == *p)
+		{
+			if (p + 1 == end && !m_bEof)
+				return ParseStatus::NeedMore;
+			if (p + 1 == end || '\n' != p[1])
+				return ParseStatus::Error;
+			++p;
+		}
+		if ('\n' == *p)
+		{
+			++lines;
+			++p;
+			break;
+		}
+		return ParseStatus::Error;
+	}
+
+	ioPos = p;
+	outLines = lines;
+	return ParseStatus::Ok;
+}
+
+
+bool CsvReader::Fill()
+{
+	if (m_bEof || !m_stream)
+	{
+		m_bEof = true;
+		return true;
+	}
+	// Keep the unparsed data.
+	if (0 < m_pos)
+	{
+		memmove(m_buffer.data(), m_buffer.data() + m_pos, m_end - m_pos);
+		m_end -= m_pos;
+		m_pos = 0;
+	}
+	if (m_end == m_buffer.size())
+		m_buffer.resize(m_buffer.size() * 2);
+	size_t request = m_buffer.size() - m_end;
+	m_stream->read(m_buffer.data() + m_end, static_cast<std::streamsize>(request));
+	size_t got = static_cast<size_t>(m_stream->gcount());
+	m_end += got;
+	m_data = m_buffer.data();
+	if (got < request)
+	{
+		m_bEof = true;
+		// A failed read is not the end of the data: don't parse what is
+		// buffered as if it were the last row.
+		if (m_stream->bad())
+		{
+			m_bError = true;
+			m_bReadError = true;
+			m_line = m_nextLine;
+			return false;
+		}
+	}
+	return true;
+}
+
+
+CsvResult ReadCsvRows(
+	std::string_view inData,
+	char inSep,
+	std::vector<std::vector<std::string>>& outRows,
+	size_t nThreads,
+	CsvProgress const& inProgress,
+	size_t* outErrorLine)
+{
+	outRows.clear();
+	if (outErrorLine)
+		*outErrorLine = 0;
+
+	// Strip the BOM here so chunks never see it.
+	size_t start = 0;
+	if (3 <= inData.size() && 0 == memcmp(inData.data(), "\xEF\xBB\xBF", 3))
+		start = 3;
+	size_t const total = inData.size();
+
+	if (0 == nThreads)
+		nThreads = GetDefaultThreadCount();
+	size_t chunkSize = std::max(MinChunkSize, (total - start) / (nThreads * ChunksPerThread) + 1);
+	size_t nChunks = std::max<size_t>(1, (total - start + chunkSize - 1) / chunkSize);
+
+	// Pass 1: scan chunks for quotes and newlines.
+	std::vector<CsvChunkInfo> chunks(nChunks);
+	ParallelFor(nChunks, nThreads, [&](size_t idx) {
+		size_t begin = start + idx * chunkSize;
+		size_t end = std::min(total, begin + chunkSize);
+		chunks[idx] = ScanChunk(inData.data() + begin, inData.data() + end);
+	});
+
+	// Resolve the real record boundaries: the first newline in each chunk
+	// that is outside quotes, given the quote state at the chunk's start.
+	std::vector<CsvRange> ranges(1);
+	ranges[0].begin = start;
+	size_t parity = 0;
+	size_t line = 1;
+	for (size_t idx = 1; idx < nChunks; ++idx)
+	{
+		parity = (parity + chunks[idx - 1].quotes) & 1;
+		line += chunks[idx - 1].lines;
+		auto const& chunk = chunks[idx];
+		if (std::string_view::npos == chunk.firstNewline[parity])
+			continue;
+		size_t boundary = start + idx * chunkSize + chunk.firstNewline[parity] + 1;
+		// A BOM would be skipped by the chunk's reader, a sequential read
+		// keeps it as data.
+		if (boundary == total || 0 == inData.compare(boundary, 3, "\xEF\xBB\xBF"))
+			continue;
+		ranges.back().end = boundary;
+		ranges.emplace_back();
+		ranges.back().begin = boundary;
+		ranges.back().line = line + chunk.linesBefore[parity] + 1;
+	}
+	ranges.back().end = total;
+
+	// Pass 2: parse. Progress is only reported on this thread.
+	std::thread::id const caller = std::this_thread::get_id();
+	std::atomic<size_t> done(0);
+	std::atomic<bool> bCanceled(false);
+	ParallelFor(ranges.size(), nThreads, [&](size_t idx) {
+		if (bCanceled)
+			return;
+		ParseRange(inData, inSep, ranges[idx]);
+		done += ranges[idx].end - ranges[idx].begin;
+		if (inProgress && std::this_thread::get_id() == caller && !inProgress(done, total))
+			bCanceled = true;
+	});
+	if (bCanceled)
+		return CsvResult::Canceled;
+
+	size_t nRows = 0;
+	for (auto const& range : ranges)
+	{
+		if (range.bError)
+		{
+			if (outErrorLine)
+				*outErrorLine = range.errorLine;
+			return CsvResult::Error;
+		}
+		nRows += range.rows.size();
+	}
+	outRows.reserve(nRows);
+	for (auto& range : ranges)
+	{
+		std::move(range.rows.begin(), range.rows.end(), std::back_inserter(outRows));
+		range.rows.clear();
+		range.rows.shrink_to_fit();
+	}
+	if (inProgress && !inProgress(total, total))
+	{
+		outRows.clear();
+		return CsvResult::Canceled;
+	}
+	return CsvResult::Ok;
+}
+
+
+CsvResult ReadCsvFile(
+	wxString const& inFileName,
+	char inSep,
+	std::vector<std::vector<std::string>>& outRows,
+	size_t nThreads,
+	CsvProgress const& inProgress,
+	size_t* outErrorLine)
+{
+	outRows.clear();
+	if (outErrorLine)
+		*outErrorLine = 0;
+
+	wxFFile file;
+	if (!file.Open(inFileName, L"rb"))
+		return CsvResult::Error;
+	auto length = file.Length();
+	std::string data(0 < length ? static_cast<size_t>(length) : 0, '\0');
+	if (!data.empty() && file.Read(&data[0], data.size()) != data.size())
+		return CsvResult::Error;
+	file.Close();
+
+	return ReadCsvRows(data, inSep, outRows, nThreads, inProgress, outErrorLine);
+}
+
+} // namespace ARBCommon
+} // namespace dconSoft
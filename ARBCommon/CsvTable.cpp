@@ -0,0 +1,394 @@
+/*
+ * Copyright (c) David Connet. All Rights Reserved.
+ *
+ * License: See License.txt
+ */
+
+/**
+ * @file
+ * @brief Columnar, typed CSV import
+ * @author David Connet
+ *
+ * Revision History
+ * 2026-10-19 Widen a column in place instead of importing again.
+ * 2026-10-19 Accept a leading '+' on numbers.
+ * 2026-10-19 Created
+ */
+
+#include "stdafx.h"
+#include "ARBCommon/CsvTable.h"
+
+#include <charconv>
+
+#if defined(__WXMSW__)
+#include <wx/msw/msvcrt.h>
+#endif
+
+
+namespace dconSoft
+{
+namespace ARBCommon
+{
+
+namespace
+{
+// Rows used to infer column types.
+constexpr size_t SampleRows = 1000;
+
+
+// from_chars doesn't accept a leading '+' (strtod and friends do).
+// Drop it, but not a second sign after it.
+bool SkipPlus(std::string_view& ioField)
+{
+	if (ioField.empty() || '+' != ioField[0])
+		return true;
+	ioField.remove_prefix(1);
+	return ioField.empty() || ('+' != ioField[0] && '-' != ioField[0]);
+}
+
+
+bool ParseInteger(std::string_view inField, int64_t& outValue)
+{
+	if (!SkipPlus(inField))
+		return false;
+	char const* end = inField.data() + inField.size();
+	auto result = std::from_chars(inField.data(), end, outValue);
+	return std::errc() == result.ec && end == result.ptr;
+}
+
+
+bool ParseDouble(std::string_view inField, double& outValue)
+{
+	// Plain C locale numbers only: no inf, nan or hex.
+	if (std::string_view::npos != inField.find_first_not_of("0123456789+-.eE"))
+		return false;
+	if (!SkipPlus(inField))
+		return false;
+#if defined(__cpp_lib_to_chars)
+	char const* end = inField.data() + inField.size();
+	auto result = std::from_chars(inField.data(), end, outValue);
+	return std::errc() == result.ec && end == result.ptr;
+#else
+	// No floating point from_chars in this library.
+	return wxString::FromUTF8(inField.data(), inField.size()).ToCDouble(&outValue);
+#endif
+}
+
+
+bool ParseDate(std::string_view inField, ARBDateFormat inDateFormat, ARBDate& outDate)
+{
+	outDate = ARBDate::Parse(inField, inDateFormat);
+	return outDate.IsValid();
+}
+
+
+// Next more general type that can hold the value.
+CsvColumnType Generalize(CsvColumnType inType, std::string_view inField)
+{
+	double value;
+	if (CsvColumnType::Integer == inType && ParseDouble(inField, value))
+		return CsvColumnType::Double;
+	return CsvColumnType::String;
+}
+
+
+// What a column's sampled values could be.
+struct CsvTypeSample
+{
+	bool bInteger = true;
+	bool bDouble = true;
+	bool bDate = true;
+
+	void Add(std::string_view inField, ARBDateFormat inDateFormat)
+	{
+		if (inField.empty())
+			return;
+		int64_t i;
+		double d;
+		ARBDate date;
+		bInteger = bInteger && ParseInteger(inField, i);
+		bDouble = bDouble && ParseDouble(inField, d);
+		bDate = bDate && ParseDate(inField, inDateFormat, date);
+	}
+
+	CsvColumnType GetType() const
+	{
+		// A column with no sampled values starts as the most specific type.
+		if (bInteger)
+			return CsvColumnType::Integer;
+		if (bDouble)
+			return CsvColumnType::Double;
+		if (bDate)
+			return CsvColumnType::Date;
+		return CsvColumnType::String;
+	}
+};
+} // namespace
+
+/////////////////////////////////////////////////////////////////////////////
+
+CsvColumn::CsvColumn(std::string_view inName, CsvColumnType inType)
+	: m_name(inName)
+	, m_type(inType)
+	, m_empty()
+	, m_integers()
+	, m_doubles()
+	, m_codes()
+	, m_dictionary()
+	, m_lookup()
+{
+}
+
+
+int64_t CsvColumn::GetInteger(size_t inRow) const
+{
+	assert(CsvColumnType::Integer == m_type);
+	if (CsvColumnType::Integer != m_type)
+		return 0;
+	return m_integers[inRow];
+}
+
+
+double CsvColumn::GetDouble(size_t inRow) const
+{
+	assert(CsvColumnType::Integer == m_type || CsvColumnType::Double == m_type);
+	if (CsvColumnType::Integer == m_type)
+		return static_cast<double>(m_integers[inRow]);
+	if (CsvColumnType::Double != m_type)
+		return 0.0;
+	return m_doubles[inRow];
+}
+
+
+ARBDate CsvColumn::GetDate(size_t inRow) const
+{
+	assert(CsvColumnType::Date == m_type);
+	ARBDate date;
+	if (CsvColumnType::Date == m_type)
+		date.SetJulianDay(static_cast<long>(m_integers[inRow]));
+	return date;
+}
+
+
+std::string_view CsvColumn::GetString(size_t inRow) const
+{
+	assert(CsvColumnType::String == m_type);
+	if (CsvColumnType::String != m_type)
+		return std::string_view();
+	return m_dictionary[m_codes[inRow]];
+}
+
+
+uint32_t CsvColumn::GetCode(size_t inRow) const
+{
+	assert(CsvColumnType::String == m_type);
+	if (CsvColumnType::String != m_type)
+		return 0;
+	return m_codes[inRow];
+}
+
+
+bool CsvColumn::Add(std::string_view inField, ARBDateFormat inDateFormat)
+{
+	if (inField.empty())
+	{
+		AddEmpty();
+		return true;
+	}
+
+	switch (m_type)
+	{
+	case CsvColumnType::Integer:
+	{
+		int64_t value;
+		if (!ParseInteger(inField, value))
+			return false;
+		m_integers.push_back(value);
+	}
+	break;
+
+	case CsvColumnType::Double:
+	{
+		double value;
+		if (!ParseDouble(inField, value))
+			return false;
+		m_doubles.push_back(value);
+	}
+	break;
+
+	case CsvColumnType::Date:
+	{
+		ARBDate date;
+		if (!ParseDate(inField, inDateFormat, date))
+			return false;
+		m_integers.push_back(date.GetJulianDay());
+	}
+	break;
+
+	case CsvColumnType::String:
+	{
+		auto iter = m_lookup.find(inField);
+		if (iter == m_lookup.end())
+		{
+			m_dictionary.emplace_back(inField);
+			iter = m_lookup.emplace(m_dictionary.back(), static_cast<uint32_t>(m_dictionary.size() - 1)).first;
+		}
+		m_codes.push_back(iter->second);
+	}
+	break;
+	}
+	m_empty.push_back(false);
+	return true;
+}
+
+
+void CsvColumn::AddEmpty()
+{
+	switch (m_type)
+	{
+	case CsvColumnType::Integer:
+	case CsvColumnType::Date:
+		m_integers.push_back(0);
+		break;
+	case CsvColumnType::Double:
+		m_doubles.push_back(0.0);
+		break;
+	case CsvColumnType::String:
+	{
+		auto iter = m_lookup.find(std::string_view());
+		if (iter == m_lookup.end())
+		{
+			m_dictionary.emplace_back();
+			iter = m_lookup.emplace(m_dictionary.back(), static_cast<uint32_t>(m_dictionary.size() - 1)).first;
+		}
+		m_codes.push_back(iter->second);
+	}
+	break;
+	}
+	m_empty.push_back(true);
+}
+
+
+void CsvColumn::ChangeToDouble()
+{
+	assert(CsvColumnType::Integer == m_type);
+	m_doubles.reserve(m_integers.size());
+	for (auto value : m_integers)
+		m_doubles.push_back(static_cast<double>(value));
+	m_integers.clear();
+	m_integers.shrink_to_fit();
+	m_type = CsvColumnType::Double;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+CsvTable::CsvTable()
+	: m_columns()
+	, m_rows(0)
+{
+}
+
+
+CsvTable::~CsvTable()
+{
+}
+
+
+CsvResult CsvTable::Read(
+	std::string_view inData,
+	char inSep,
+	bool inHasHeader,
+	ARBDateFormat inDateFormat,
+	size_t* outErrorLine)
+{
+	if (outErrorLine)
+		*outErrorLine = 0;
+
+	// Infer the types.
+	std::vector<CsvTypeSample> samples;
+	{
+		CsvReader reader(inData, inSep);
+		if (inHasHeader && reader.ReadRow())
+			samples.resize(reader.Fields().size());
+		for (size_t row = 0; row < SampleRows && reader.ReadRow(); ++row)
+		{
+			auto const& fields = reader.Fields();
+			if (samples.size() < fields.size())
+				samples.resize(fields.size());
+			for (size_t col = 0; col < fields.size(); ++col)
+				samples[col].Add(fields[col], inDateFormat);
+		}
+	}
+	m_columns.clear();
+	m_rows = 0;
+
+	CsvReader reader(inData, inSep);
+	std::vector<std::string> names;
+	if (inHasHeader && reader.ReadRow())
+		names.assign(reader.Fields().begin(), reader.Fields().end());
+	auto columnName = [&names](size_t col) {
+		return col < names.size() ? std::string_view(names[col]) : std::string_view();
+	};
+	m_columns.reserve(samples.size());
+	for (size_t col = 0; col < samples.size(); ++col)
+		m_columns.push_back(CsvColumn(columnName(col), samples[col].GetType()));
+
+	while (reader.ReadRow())
+	{
+		auto const& fields = reader.Fields();
+		for (size_t col = 0; col < fields.size(); ++col)
+		{
+			if (col == m_columns.size())
+			{
+				// More fields than any row so far.
+				m_columns.push_back(CsvColumn(columnName(col), CsvColumnType::String));
+				for (size_t row = 0; row < m_rows; ++row)
+					m_columns[col].AddEmpty();
+			}
+			if (!m_columns[col].Add(fields[col], inDateFormat))
+			{
+				if (CsvColumnType::Double == Generalize(m_columns[col].GetType(), fields[col]))
+					m_columns[col].ChangeToDouble();
+				else
+					ChangeToString(inData, inSep, inHasHeader, col);
+				m_columns[col].Add(fields[col], inDateFormat);
+			}
+		}
+		for (size_t col = fields.size(); col < m_columns.size(); ++col)
+			m_columns[col].AddEmpty();
+		++m_rows;
+	}
+
+	if (reader.IsError())
+	{
+		if (outErrorLine)
+			*outErrorLine = reader.GetLineNumber();
+		m_columns.clear();
+		m_rows = 0;
+		return CsvResult::Error;
+	}
+	return CsvResult::Ok;
+}
+
+
+// The typed values can't be turned back into the original text, so read
+// the column's first m_rows values again.
+void CsvTable::ChangeToString(std::string_view inData, char inSep, bool inHasHeader, size_t inColumn)
+{
+	CsvColumn column(m_columns[inColumn].GetName(), CsvColumnType::String);
+	CsvReader reader(inData, inSep);
+	if (inHasHeader)
+		reader.ReadRow();
+	for (size_t row = 0; row < m_rows && reader.ReadRow(); ++row)
+	{
+		auto const& fields = reader.Fields();
+		if (inColumn < fields.size())
+			column.Add(fields[inColumn], ARBDateFormat::ISO);
+		else
+			column.AddEmpty();
+	}
+	m_columns[inColumn] = std::move(column);
+}
+
+} // namespace ARBCommon
+} // namespace dconSoft
@@ -0,0 +1,184 @@
+/*
+ * Copyright (c) David Connet. All Rights Reserved.
+ *
+ * License: See License.txt
+ */
+
+/**
+ * @file
+ * @brief Buffered CSV writer
+ * @author David Connet
+ *
+ * Revision History
+ * 2026-10-19 Quote a row's only field when it is empty.
+ * 2026-10-19 Created
+ */
+
+#include "stdafx.h"
+#include "ARBCommon/CsvWriter.h"
+
+#include <cstring>
+
+#if defined(__WXMSW__)
+#include <wx/msw/msvcrt.h>
+#endif
+
+
+namespace dconSoft
+{
+namespace ARBCommon
+{
+
+namespace
+{
+// Stream output is written once this much is buffered.
+constexpr size_t FlushSize = 64 * 1024;
+} // namespace
+
+
+CsvWriter::CsvWriter(std::ostream& outStream, char inSep, bool bAlwaysQuote)
+	: m_stream(&outStream)
+	, m_buffer()
+	, m_out(m_buffer)
+	, m_sep(inSep)
+	, m_bAlwaysQuote(bAlwaysQuote)
+	, m_bRowStarted(false)
+	, m_bEmptyRow(false)
+	, m_special()
+{
+	m_buffer.reserve(FlushSize + FlushSize / 4);
+	m_special[static_cast<unsigned char>(m_sep)] = true;
+	m_special[static_cast<unsigned char>('"')] = true;
+	m_special[static_cast<unsigned char>('\r')] = true;
+	m_special[static_cast<unsigned char>('\n')] = true;
+}
+
+
+CsvWriter::CsvWriter(std::string& outBuffer, char inSep, bool bAlwaysQuote)
+	: m_stream(nullptr)
+	, m_buffer()
+	, m_out(outBuffer)
+	, m_sep(inSep)
+	, m_bAlwaysQuote(bAlwaysQuote)
+	, m_bRowStarted(false)
+	, m_bEmptyRow(false)
+	, m_special()
+{
+	m_special[static_cast<unsigned char>(m_sep)] = true;
+	m_special[static_cast<unsigned char>('"')] = true;
+	m_special[static_cast<unsigned char>('\r')] = true;
+	m_special[static_cast<unsigned char>('\n')] = true;
+}
+
+
+CsvWriter::~CsvWriter()
+{
+	Flush();
+}
+
+
+void CsvWriter::Separator()
+{
+	if (m_bRowStarted)
+		m_out += m_sep;
+	m_bRowStarted = true;
+}
+
+
+void CsvWriter::Field(std::string_view inField)
+{
+	m_bEmptyRow = !m_bRowStarted && inField.empty() && !m_bAlwaysQuote;
+	Separator();
+
+	char const* p = inField.data();
+	char const* end = p + inField.size();
+	char const* special = p;
+	while (special != end && !m_special[static_cast<unsigned char>(*special)])
+		++special;
+
+	if (special == end)
+	{
+		if (m_bAlwaysQuote)
+			m_out += '"';
+		m_out.append(p, inField.size());
+		if (m_bAlwaysQuote)
+			m_out += '"';
+	}
+	else
+	{
+		// Copy runs up to and including each quote, then double it.
+		m_out += '"';
+		for (;;)
+		{
+			char const* quote = static_cast<char const*>(memchr(special, '"', static_cast<size_t>(end - special)));
+			if (!quote)
+				break;
+			m_out.append(p, static_cast<size_t>(quote - p) + 1);
+			m_out += '"';
+			p = special = quote + 1;
+		}
+		m_out.append(p, static_cast<size_t>(end - p));
+		m_out += '"';
+	}
+
+	if (m_stream && FlushSize <= m_buffer.size())
+		Flush();
+}
+
+
+void CsvWriter::Field(wxString const& inField)
+{
+	auto utf8 = inField.utf8_str();
+	Field(std::string_view(utf8.data(), utf8.length()));
+}
+
+
+void CsvWriter::EndRow()
+{
+	// A bare newline would read back as a row with no fields.
+	if (m_bEmptyRow)
+		m_out += "\"\"";
+	m_out += '\n';
+	m_bRowStarted = false;
+	m_bEmptyRow = false;
+}
+
+
+void CsvWriter::WriteRow(std::vector<std::string> const& inFields)
+{
+	for (auto const& field : inFields)
+		Field(std::string_view(field));
+	EndRow();
+}
+
+
+void CsvWriter::WriteRow(std::vector<std::string_view> const& inFields)
+{
+	for (auto field : inFields)
+		Field(field);
+	EndRow();
+}
+
+
+void CsvWriter::WriteRow(std::vector<wxString> const& inFields)
+{
+	for (auto const& field : inFields)
+		Field(field);
+	EndRow();
+}
+
+
+bool CsvWriter::Flush()
+{
+	if (!m_stream)
+		return true;
+	if (!m_buffer.empty())
+	{
+		m_stream->write(m_buffer.data(), static_cast<std::streamsize>(m_buffer.size()));
+		m_buffer.clear();
+	}
+	return m_stream->good();
+}
+
+} // namespace ARBCommon
+} // namespace dconSoft
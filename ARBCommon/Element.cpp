@@ -12,6 +12,7 @@
  * Actual reading and writing of XML is done using wxWidgets
  *
  * Revision History
+ * 2026-10-19 Read/write CUniqueId attributes without temporary strings.
  * 2022-08-29 Add UTC wxDateTime support.
  * 2022-01-31 Add wxDateTime support.
  * 2017-08-03 Added initial expat support (reader, not write)
@@ -614,14 +615,13 @@ ARBAttribLookup ElementNode::GetAttrib(wxString const& inName, double& outValue)
 
 ARBAttribLookup ElementNode::GetAttrib(wxString const& inName, CUniqueId& outValue) const
 {
-	wxString value;
-	ARBAttribLookup rc = GetAttrib(inName, value);
-	if (ARBAttribLookup::Found == rc)
-	{
-		if (!outValue.ParseString(value) || outValue.IsNull())
-			rc = ARBAttribLookup::Invalid;
-	}
-	return rc;
+	MyAttributes::const_iterator iter = m_Attribs.find(inName);
+	if (iter == m_Attribs.end())
+		return ARBAttribLookup::NotFound;
+	// ParseString works on the stored string directly (no copy).
+	if (!outValue.ParseString(iter->second))
+		return ARBAttribLookup::Invalid;
+	return ARBAttribLookup::Found;
 }
 
 
@@ -735,7 +735,11 @@ bool ElementNode::AddAttrib(wxString const& inName, double inValue, int inPrec)
 
 bool ElementNode::AddAttrib(wxString const& inName, CUniqueId const& inValue)
 {
-	return AddAttrib(inName, inValue.ToString());
+	if (inName.empty())
+		return false;
+	wchar_t buffer[CUniqueId::StringLength];
+	m_Attribs[inName].assign(buffer, inValue.FormatTo(buffer));
+	return true;
 }
 
 
@@ -9,6 +9,10 @@
  * @brief UUID class
  *
  * Revision History
+ * 2026-10-19 Parse and format directly instead of through stduuid strings.
+ * 2026-10-19 Store the id inline instead of in a heap allocated impl.
+ * 2026-10-19 Reuse a per-thread random generator, add CreateMany.
+ *            Fix move construction/assignment (both objects owned the impl).
  * 2022-10-05 Created
  */
 
@@ -34,207 +38,232 @@ namespace dconSoft
 namespace ARBCommon
 {
 
-class CUniqueIdImpl
+namespace
 {
-	CUniqueIdImpl(CUniqueIdImpl&& rhs) = delete;
-	CUniqueIdImpl& operator=(CUniqueIdImpl const&) = delete;
-	CUniqueIdImpl& operator=(CUniqueIdImpl&&) = delete;
-
-public:
-	CUniqueIdImpl()
-		: m_uuid()
-	{
-	}
-	~CUniqueIdImpl() = default;
-
-	CUniqueIdImpl(CUniqueIdImpl const& rhs)
-		: m_uuid{rhs.m_uuid}
-	{
-	}
-
-	void clear()
-	{
-		m_uuid = uuids::uuid();
-	}
-
-	bool Create()
-	{
-#ifdef UUID_SYSTEM_GENERATOR
-		m_uuid = uuids::uuid_system_generator{}();
-#else
+#ifndef UUID_SYSTEM_GENERATOR
+// Seeding fills the entire mt19937 state from std::random_device, so only do
+// that once per thread and then keep using the generator.
+uuids::uuid_random_generator& GetRandomGenerator()
+{
+	thread_local std::mt19937 engine = []() {
 		std::random_device rd;
 		auto seed_data = std::array<int, std::mt19937::state_size>{};
 		std::generate(std::begin(seed_data), std::end(seed_data), std::ref(rd));
 		std::seed_seq seq(std::begin(seed_data), std::end(seed_data));
-		std::mt19937 generator(seq);
-		uuids::uuid_random_generator gen{generator};
-
-		m_uuid = gen();
+		return std::mt19937(seq);
+	}();
+	thread_local uuids::uuid_random_generator gen{engine};
+	return gen;
+}
 #endif
-		return !m_uuid.is_nil();
-	}
-
-	CUniqueIdImpl* Clone() const
-	{
-		return new CUniqueIdImpl(*this);
-	}
 
-	bool IsNull() const
-	{
-		return m_uuid.is_nil();
-	}
 
-	void Assign(CUniqueIdImpl const* rhs)
-	{
-		m_uuid = rhs->m_uuid;
-	}
+uuids::uuid NewUuid()
+{
+#ifdef UUID_SYSTEM_GENERATOR
+	return uuids::uuid_system_generator{}();
+#else
+	return GetRandomGenerator()();
+#endif
+}
 
-	bool IsEqual(CUniqueIdImpl const* rhs) const
-	{
-		return m_uuid == rhs->m_uuid;
-	}
 
-	bool IsLessThan(CUniqueIdImpl const* rhs) const
-	{
-		return m_uuid < rhs->m_uuid;
-	}
+template <typename BYTES> void CopyBytes(uuids::uuid const& inUuid, BYTES& outBytes)
+{
+	auto bytes = inUuid.as_bytes();
+	static_assert(sizeof(outBytes) == 16, "Unexpected uuid size");
+	memcpy(outBytes.data(), bytes.data(), sizeof(outBytes));
+}
 
-	wxString ToString() const
-	{
-		return uuids::to_string<wchar_t>(m_uuid);
-	}
 
-	bool ParseString(wxString const& str)
+// Value of each hex digit, 0xff for anything else.
+constexpr std::array<uint8_t, 256> MakeHexTable()
+{
+	std::array<uint8_t, 256> table{};
+	for (unsigned int c = 0; c < table.size(); ++c)
 	{
-		auto uuid = uuids::uuid::from_string(str.wc_str());
-		if (uuid)
-			m_uuid = *uuid;
+		if ('0' <= c && c <= '9')
+			table[c] = static_cast<uint8_t>(c - '0');
+		else if ('a' <= c && c <= 'f')
+			table[c] = static_cast<uint8_t>(c - 'a' + 10);
+		else if ('A' <= c && c <= 'F')
+			table[c] = static_cast<uint8_t>(c - 'A' + 10);
 		else
-			clear();
-		return !m_uuid.is_nil();
+			table[c] = 0xff;
 	}
+	return table;
+}
+constexpr std::array<uint8_t, 256> k_hexTable = MakeHexTable();
 
-private:
-#if 0
-	// This was originally written directly to the Win32 api.
-	// That can only parse strings in a normalized form.
-	// At first CUniqueIdImpl was virtual (with this func) and I had
-	// CUniqueIdImplMS and CUniqueIdImplStd impls. Decided just to use
-	// stduuid (with it using the system generators).
-
-	// Normalize format to "hhhhhhhh-hhhh-hhhh-hhhh-hhhhhhhhhhhh"
-	wxString NormalizeString(wxString  const& str)
-	{
-		auto len = str.length();
-		if (36 == len)
-			return str;
-		if (38 == len && str[0] == '{')
-			return str.substr(1, str.length() - 2);
-		wxString s(str);
-		if (34 == len && str[0] == '{')
-			s = str.substr(1, str.length() - 2);
-		if (32 == s.length())
-		{
-			std::wstringstream ss;
-			ss << s.substr(0, 8) << '-' << s.substr(8, 4) << '-' << s.substr(12, 4) << '-' << s.substr(16, 4) << '-'
-			   << s.substr(20);
-			s = ss.str();
-		}
-		return s;
-	}
-#endif
-
-	uuids::uuid m_uuid;
-};
-
-/////////////////////////////////////////////////////////////////////////////
 
-CUniqueId::CUniqueId()
-	: m_impl(new CUniqueIdImpl())
+template <typename CharT> uint8_t HexValue(CharT c)
 {
+	auto u = static_cast<typename std::make_unsigned<CharT>::type>(c);
+	return u < k_hexTable.size() ? k_hexTable[u] : 0xff;
 }
 
 
-CUniqueId::CUniqueId(wxString const& str)
-	: CUniqueId()
-{
-	m_impl->ParseString(str);
-}
+// Offsets of each byte in hhhhhhhh-hhhh-hhhh-hhhh-hhhhhhhhhhhh
+constexpr size_t k_byteOffsets[16] = {0, 2, 4, 6, 9, 11, 14, 16, 19, 21, 24, 26, 28, 30, 32, 34};
 
 
-CUniqueId::CUniqueId(CUniqueId const& rhs)
-	: m_impl(rhs.m_impl->Clone())
+// Same rules as uuids::uuid::from_string: optional braces, then 32 hex
+// digits. Hyphens are ignored wherever they are.
+template <typename CharT, typename BYTES> bool ParseHex(CharT const* str, size_t len, BYTES& outBytes)
 {
+	if (0 == len)
+		return false;
+	if ('{' == str[0])
+	{
+		if (1 == len || '}' != str[len - 1])
+			return false;
+		++str;
+		len -= 2;
+	}
+
+	// The normal form is decoded without branching on each digit. Invalid
+	// digits set the high bits of 'bad'.
+	if (CUniqueId::StringLength == len && '-' == str[8] && '-' == str[13] && '-' == str[18] && '-' == str[23])
+	{
+		uint8_t bad = 0;
+		for (size_t i = 0; i < sizeof(outBytes); ++i)
+		{
+			uint8_t hi = HexValue(str[k_byteOffsets[i]]);
+			uint8_t lo = HexValue(str[k_byteOffsets[i] + 1]);
+			bad |= hi | lo;
+			outBytes[i] = static_cast<uint8_t>(hi << 4 | lo);
+		}
+		return 0 == (bad & 0xf0);
+	}
+
+	size_t index = 0;
+	bool firstDigit = true;
+	for (size_t i = 0; i < len; ++i)
+	{
+		if ('-' == str[i])
+			continue;
+		uint8_t value = HexValue(str[i]);
+		if (sizeof(outBytes) <= index || 0xff == value)
+			return false;
+		if (firstDigit)
+			outBytes[index] = static_cast<uint8_t>(value << 4);
+		else
+			outBytes[index++] |= value;
+		firstDigit = !firstDigit;
+	}
+	return sizeof(outBytes) == index;
 }
 
 
-CUniqueId::CUniqueId(CUniqueId&& rhs)
-	: m_impl(std::move(rhs.m_impl))
+// hhhhhhhh-hhhh-hhhh-hhhh-hhhhhhhhhhhh
+template <typename CharT, typename BYTES> size_t FormatHex(BYTES const& inBytes, CharT* outBuffer)
 {
+	static char const digits[] = "0123456789abcdef";
+	CharT* out = outBuffer;
+	for (size_t i = 0; i < sizeof(inBytes); ++i)
+	{
+		if (4 == i || 6 == i || 8 == i || 10 == i)
+			*out++ = '-';
+		*out++ = static_cast<CharT>(digits[inBytes[i] >> 4]);
+		*out++ = static_cast<CharT>(digits[inBytes[i] & 0x0f]);
+	}
+	return static_cast<size_t>(out - outBuffer);
 }
 
 
-CUniqueId::~CUniqueId()
+#if 0
+// This was originally written directly to the Win32 api.
+// That can only parse strings in a normalized form.
+// At first CUniqueIdImpl was virtual (with this func) and I had
+// CUniqueIdImplMS and CUniqueIdImplStd impls. Decided just to use
+// stduuid (with it using the system generators).
+
+// Normalize format to "hhhhhhhh-hhhh-hhhh-hhhh-hhhhhhhhhhhh"
+wxString NormalizeString(wxString  const& str)
 {
-	delete m_impl;
+	auto len = str.length();
+	if (36 == len)
+		return str;
+	if (38 == len && str[0] == '{')
+		return str.substr(1, str.length() - 2);
+	wxString s(str);
+	if (34 == len && str[0] == '{')
+		s = str.substr(1, str.length() - 2);
+	if (32 == s.length())
+	{
+		std::wstringstream ss;
+		ss << s.substr(0, 8) << '-' << s.substr(8, 4) << '-' << s.substr(12, 4) << '-' << s.substr(16, 4) << '-'
+		   << s.substr(20);
+		s = ss.str();
+	}
+	return s;
 }
+#endif
+} // namespace
 
+/////////////////////////////////////////////////////////////////////////////
 
-void CUniqueId::clear()
+CUniqueId::CUniqueId(wxString const& str)
+	: CUniqueId()
 {
-	m_impl->clear();
+	ParseString(str);
 }
 
 
 bool CUniqueId::Create()
 {
-	return m_impl->Create();
+	CopyBytes(NewUuid(), m_bytes);
+	return !IsNull();
 }
 
 
-bool CUniqueId::IsNull() const
+std::vector<CUniqueId> CUniqueId::CreateMany(size_t inCount)
 {
-	return m_impl->IsNull();
+	std::vector<CUniqueId> ids(inCount);
+	for (auto& id : ids)
+		id.Create();
+	return ids;
 }
 
 
-CUniqueId& CUniqueId::operator=(CUniqueId const& rhs)
+wxString CUniqueId::ToString() const
 {
-	if (this != &rhs)
-		m_impl->Assign(rhs.m_impl);
-	return *this;
+	wchar_t buffer[StringLength];
+	return wxString(buffer, FormatTo(buffer));
 }
 
 
-CUniqueId& CUniqueId::operator=(CUniqueId&& rhs)
+bool CUniqueId::ParseString(wxString const& str)
 {
-	if (this != &rhs)
-		m_impl = std::move(rhs.m_impl);
-	return *this;
+	return Parse(std::wstring_view(str.wc_str(), str.length()));
 }
 
 
-bool CUniqueId::operator==(CUniqueId const& rhs) const
+size_t CUniqueId::FormatTo(char* outBuffer) const
 {
-	return m_impl->IsEqual(rhs.m_impl);
+	return FormatHex(m_bytes, outBuffer);
 }
 
 
-bool CUniqueId::operator<(CUniqueId const& rhs) const
+size_t CUniqueId::FormatTo(wchar_t* outBuffer) const
 {
-	return m_impl->IsLessThan(rhs.m_impl);
+	return FormatHex(m_bytes, outBuffer);
 }
 
 
-wxString CUniqueId::ToString() const
+bool CUniqueId::Parse(std::string_view str)
 {
-	return m_impl->ToString();
+	if (!ParseHex(str.data(), str.size(), m_bytes))
+		clear();
+	return !IsNull();
 }
 
 
-bool CUniqueId::ParseString(wxString const& str)
+bool CUniqueId::Parse(std::wstring_view str)
 {
-	return m_impl->ParseString(str);
+	if (!ParseHex(str.data(), str.size(), m_bytes))
+		clear();
+	return !IsNull();
 }
 
 } // namespace ARBCommon
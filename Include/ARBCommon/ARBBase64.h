@@ -19,6 +19,9 @@
  * The actual contained data is still 8bit chars.
  *
  * Revision History
+ * 2026-10-19 Decode takes a string_view.
+ * 2026-10-19 Added streaming encoder/decoder.
+ * 2026-10-19 Added SIMD kernels with runtime dispatch.
  * 2012-04-10 Based on wx-group thread, use std::string for internal use
  * 2009-09-13 Add support for wxWidgets 2.9, deprecate tstring.
  * 2004-03-06 Created
@@ -27,6 +30,9 @@
 #include "LibwxARBCommon.h"
 
 #include "ARBTypes.h"
+#include <functional>
+#include <ostream>
+#include <string_view>
 
 
 namespace dconSoft
@@ -36,13 +42,44 @@ namespace ARBCommon
 namespace ARBBase64
 {
 
+/**
+ * Implementation used to encode/decode.
+ * Encode/Decode use the fastest one the CPU supports.
+ */
+enum class ARBBase64Kernel
+{
+	Scalar, ///< Portable, one character at a time
+	SSE41,  ///< x86 SSE4.1 (16 characters at a time)
+	AVX2,   ///< x86 AVX2 (32 characters at a time)
+};
+
+/**
+ * Can the kernel run on this machine?
+ * @param kernel Kernel to check.
+ * @return Whether the CPU (and this build) supports it.
+ */
+ARBCOMMON_API bool IsKernelSupported(ARBBase64Kernel kernel);
+
 /**
  * Decode a base64 string.
  * @param inBase64 Encoded buffer
  * @param outBinData Decoded buffer
  * @return Success
  */
-ARBCOMMON_API bool Decode(std::string const& inBase64, std::vector<unsigned char>& outBinData);
+ARBCOMMON_API bool Decode(std::string_view inBase64, std::vector<unsigned char>& outBinData);
+
+/**
+ * Decode a base64 string using a specific kernel.
+ * This is mainly for testing, all kernels produce the same results.
+ * @param inBase64 Encoded buffer
+ * @param outBinData Decoded buffer
+ * @param kernel Kernel to use (Scalar if not supported)
+ * @return Success
+ */
+ARBCOMMON_API bool Decode(
+	std::string_view inBase64,
+	std::vector<unsigned char>& outBinData,
+	ARBBase64Kernel kernel);
 
 /**
  * Encode data
@@ -52,6 +89,100 @@ ARBCOMMON_API bool Decode(std::string const& inBase64, std::vector<unsigned char
  */
 ARBCOMMON_API bool Encode(std::vector<unsigned char> const& inBinData, std::string& outData);
 
+/**
+ * Encode data using a specific kernel.
+ * This is mainly for testing, all kernels produce the same results.
+ * @param inBinData Buffer to encode
+ * @param outData Encoded data
+ * @param kernel Kernel to use (Scalar if not supported)
+ * @return Success
+ */
+ARBCOMMON_API bool Encode(std::vector<unsigned char> const& inBinData, std::string& outData, ARBBase64Kernel kernel);
+
+
+/**
+ * Receives output from a streaming encoder/decoder.
+ * Return false to stop (the current Write/Finish call then fails).
+ */
+using ARBBase64Sink = std::function<bool(void const* data, size_t len)>;
+
+
+/**
+ * Incremental encoder. Data can be written in chunks of any size; the
+ * output is identical to Encode() on all the data at once. Memory use is
+ * constant.
+ */
+class ARBCOMMON_API CEncoder
+{
+	DECLARE_NO_COPY_IMPLEMENTED(CEncoder)
+public:
+	explicit CEncoder(ARBBase64Sink sink);
+	explicit CEncoder(std::ostream& output);
+
+	/**
+	 * Encode a chunk of data.
+	 * @param inData Data to encode.
+	 * @param inLen Number of bytes.
+	 * @return Success
+	 */
+	bool Write(void const* inData, size_t inLen);
+
+	/**
+	 * Write the final (padded) characters. Call once, after all data.
+	 * @return Success (fails if no data was written, like Encode)
+	 */
+	bool Finish();
+
+private:
+	bool Flush(char const* end);
+
+	ARBBase64Sink m_sink;
+	std::vector<char> m_buffer;
+	unsigned char m_carry[3];
+	size_t m_carryLen;
+	size_t m_lineLen;
+	bool m_bData;
+	bool m_bOk;
+};
+
+
+/**
+ * Incremental decoder. Encoded text can be written in chunks of any size
+ * (breaks may be anywhere, including in a line break or quantum); the
+ * output is identical to Decode() on all the text at once. Memory use is
+ * constant.
+ */
+class ARBCOMMON_API CDecoder
+{
+	DECLARE_NO_COPY_IMPLEMENTED(CDecoder)
+public:
+	explicit CDecoder(ARBBase64Sink sink);
+	explicit CDecoder(std::ostream& output);
+
+	/**
+	 * Decode a chunk of text. Anything after '=' is ignored.
+	 * @param inData Text to decode.
+	 * @param inLen Number of characters.
+	 * @return Success (false once invalid data has been seen)
+	 */
+	bool Write(char const* inData, size_t inLen);
+
+	/**
+	 * Write the final bytes. Call once, after all text.
+	 * @return Success (fails if no text was written, like Decode)
+	 */
+	bool Finish();
+
+private:
+	ARBBase64Sink m_sink;
+	std::vector<unsigned char> m_buffer;
+	uint32_t m_accum;
+	unsigned int m_count;
+	bool m_bData;
+	bool m_bDone;
+	bool m_bOk;
+};
+
 } // namespace ARBBase64
 } // namespace ARBCommon
 } // namespace dconSoft
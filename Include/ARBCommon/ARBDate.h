@@ -12,6 +12,11 @@
  * @author David Connet
  *
  * Revision History
+ * 2026-10-19 Lowered MaxBatchJulian to stay clear of 32bit overflow.
+ * 2026-10-19 Made the calendar math constexpr.
+ * 2026-10-19 Added batch julian day conversions and CountByPeriod.
+ * 2026-10-19 Added AppendTo and FormatTo.
+ * 2026-10-19 Added allocation-free Parse.
  * 2012-10-26 Changed ARBDate::GetTime to avoid time_t when possible.
  * 2012-04-10 Based on wx-group thread, use std::string for internal use
  * 2009-10-30 Add support for localized dates.
@@ -29,6 +34,8 @@
 #include "LibwxARBCommon.h"
 
 #include "ARBTypes.h"
+#include <string_view>
+#include <vector>
 #include <wx/datetime.h>
 
 
@@ -75,6 +82,18 @@ enum class ARBDayOfWeek
 	Saturday = 6,  ///< Saturday
 };
 
+/**
+ * Calendar periods (see ARBDate::CountByPeriod)
+ */
+enum class ARBDatePeriod
+{
+	Week,  ///< Week, starting on a given day
+	Month, ///< Calendar month
+	Year,  ///< Calendar year
+};
+
+struct ARBDatePeriodCount;
+
 
 /**
  * Date class.
@@ -91,6 +110,27 @@ public:
 	 */
 	static ARBDate FromString(wxString const& inDate, ARBDateFormat inFormat);
 
+	/**
+	 * Convert a string to a date, without any allocations (except for Locale).
+	 * Leading whitespace in a field and text after a number are ignored.
+	 * @param inDate String to convert
+	 * @param inFormat Parse using this format
+	 * @return Parsed date, if parse fails, date is invalid.
+	 */
+	static ARBDate Parse(std::wstring_view inDate, ARBDateFormat inFormat);
+	static ARBDate Parse(std::string_view inDate, ARBDateFormat inFormat);
+
+	/**
+	 * Convert an array of strings to dates.
+	 * @param inDates Strings to convert
+	 * @param inCount Number of strings
+	 * @param inFormat Parse using this format
+	 * @param outDates Parsed dates (inCount entries), invalid if parse fails.
+	 * @return Number of valid dates.
+	 */
+	static size_t Parse(std::wstring_view const* inDates, size_t inCount, ARBDateFormat inFormat, ARBDate* outDates);
+	static size_t Parse(std::string_view const* inDates, size_t inCount, ARBDateFormat inFormat, ARBDate* outDates);
+
 	/**
 	 * Get a string showing the valid date range (if set)
 	 * @param inFrom Valid from date.
@@ -108,15 +148,168 @@ public:
 	 */
 	static ARBDate Today();
 
-	ARBDate()
+	/*
+	 * The following public domain code was found on the internet
+	 * (calendar-1.11). SDN stands for serial day number. The author notes it
+	 * is called this to differentiate the julian day (SDN) from a Julian
+	 * calendar date. It has been modified only slightly.
+	 *
+	 * $selId: gregor.c,v 2.0 1995/10/24 01:13:06 lees Exp $
+	 * Copyright 1993-1995, Scott E. Lee, all rights reserved.
+	 * Permission granted to use, copy, modify, distribute and sell so long as
+	 * the above copyright and this permission statement are retained in all
+	 * copies.  THERE IS NO WARRANTY - USE AT YOUR OWN RISK.
+	 *
+	 * VALID RANGE
+	 *     4714 B.C. to at least 10000 A.D.
+	 * REFERENCES
+	 *     Conversions Between Calendar Date and Julian Day Number by Robert J.
+	 *     Tantzen, Communications of the Association for Computing Machinery
+	 *     August 1963.  (Also published in Collected Algorithms from CACM,
+	 *     algorithm number 199).
+	 */
+
+	/**
+	 * Convert a julian day to a Gregorian date (0/0/0 if sdn <= 0).
+	 * There is no year 0: 1 B.C. is -1.
+	 */
+	static constexpr void SdnToGregorian(long sdn, int& outYear, int& outMonth, int& outDay)
+	{
+		if (sdn <= 0)
+		{
+			outYear = 0;
+			outMonth = 0;
+			outDay = 0;
+			return;
+		}
+
+		long temp = (sdn + SDN_OFFSET) * 4 - 1;
+
+		/* Calculate the century (year/100). */
+		long century = temp / DAYS_PER_400_YEARS;
+
+		/* Calculate the year and day of year (1 <= dayOfYear <= 366). */
+		temp = ((temp % DAYS_PER_400_YEARS) / 4) * 4 + 3;
+		long year = (century * 100) + (temp / DAYS_PER_4_YEARS);
+		long dayOfYear = (temp % DAYS_PER_4_YEARS) / 4 + 1;
+
+		/* Calculate the month and day of month. */
+		temp = dayOfYear * 5 - 3;
+		long month = temp / DAYS_PER_5_MONTHS;
+		long day = (temp % DAYS_PER_5_MONTHS) / 5 + 1;
+
+		/* Convert to the normal beginning of the year. */
+		if (month < 10)
+			month += 3;
+		else
+		{
+			year += 1;
+			month -= 9;
+		}
+
+		/* Adjust to the B.C./A.D. type numbering. */
+		year -= 4800;
+		if (year <= 0)
+			year--;
+
+		outYear = static_cast<int>(year);
+		outMonth = static_cast<int>(month);
+		outDay = static_cast<int>(day);
+	}
+
+	/**
+	 * Convert a Gregorian date to a julian day (0 if invalid).
+	 * Only the ranges are checked: Feb 31 is converted to Mar 3 (or 2).
+	 */
+	static constexpr long GregorianToSdn(int inputYear, int inputMonth, int inputDay)
+	{
+		/* check for invalid dates */
+		if (inputYear == 0 || inputYear < -4714 || inputMonth <= 0 || inputMonth > 12 || inputDay <= 0
+			|| inputDay > 31)
+		{
+			return 0;
+		}
+
+		/* check for dates before SDN 1 (Nov 25, 4714 B.C.) */
+		if (inputYear == -4714)
+		{
+			if (inputMonth < 11)
+				return 0;
+			if (inputMonth == 11 && inputDay < 25)
+				return 0;
+		}
+
+		/* Make year always a positive number. */
+		long year = inputYear < 0 ? inputYear + 4801 : inputYear + 4800;
+
+		/* Adjust the start of the year. */
+		long month = 0;
+		if (inputMonth > 2)
+			month = inputMonth - 3;
+		else
+		{
+			month = inputMonth + 9;
+			year--;
+		}
+
+		return (
+			((year / 100) * DAYS_PER_400_YEARS) / 4 + ((year % 100) * DAYS_PER_4_YEARS) / 4
+			+ (month * DAYS_PER_5_MONTHS + 2) / 5 + inputDay - SDN_OFFSET);
+	}
+
+	/**
+	 * Largest julian day handled by the batch functions below.
+	 * Those work on arrays of julian days (see GetJulianDay), without
+	 * branches so the compiler can vectorize them. Invalid days (<= 0, or
+	 * past MaxBatchJulian) give 0 in every output.
+	 * The limit (about year 1,364,000) keeps the 32bit math here, and the
+	 * scalar conversions where long is 32 bits, from overflowing.
+	 */
+	static constexpr long MaxBatchJulian = 500000000L;
+
+	/**
+	 * Convert to year/month/day (see GetDate).
+	 */
+	static void GetDates(long const* inJulian, size_t inCount, int* outYr, int* outMon, int* outDay);
+
+	/**
+	 * Day of the week (see GetDayOfWeek).
+	 */
+	static void GetDaysOfWeek(
+		long const* inJulian,
+		size_t inCount,
+		int* outDayOfWeek,
+		ARBDayOfWeek inFirstDay = ARBDayOfWeek::Sunday);
+
+	/**
+	 * Day of the year, 1-366 (see GetDayOfYear).
+	 */
+	static void GetDaysOfYear(long const* inJulian, size_t inCount, int* outDayOfYear);
+
+	/**
+	 * Count the dates in each calendar period.
+	 * @param inJulian Julian days. Invalid days are ignored.
+	 * @param inCount Number of days.
+	 * @param inPeriod Period to group by.
+	 * @param outCounts Periods containing dates, in date order.
+	 * @param inFirstDay First day of a week (ARBDatePeriod::Week).
+	 */
+	static void CountByPeriod(
+		long const* inJulian,
+		size_t inCount,
+		ARBDatePeriod inPeriod,
+		std::vector<ARBDatePeriodCount>& outCounts,
+		ARBDayOfWeek inFirstDay = ARBDayOfWeek::Sunday);
+
+	constexpr ARBDate()
 		: m_Julian(0)
 	{
 	}
-	ARBDate(ARBDate const& rhs)
+	constexpr ARBDate(ARBDate const& rhs)
 		: m_Julian(rhs.m_Julian)
 	{
 	}
-	ARBDate(ARBDate&& rhs)
+	constexpr ARBDate(ARBDate&& rhs)
 		: m_Julian(std::move(rhs.m_Julian))
 	{
 	}
@@ -128,20 +321,18 @@ public:
 		*this = date;
 	}
 #endif
-	ARBDate(int inYr, int inMon, int inDay)
+	constexpr ARBDate(int inYr, int inMon, int inDay)
 		: m_Julian(0)
 	{
 		SetDate(inYr, inMon, inDay);
 	}
 
-	~ARBDate()
-	{
-	}
+	~ARBDate() = default;
 
 	/**
 	 * Is the date valid?
 	 */
-	bool IsValid() const
+	constexpr bool IsValid() const
 	{
 		return (0 < m_Julian);
 	}
@@ -149,7 +340,7 @@ public:
 	/**
 	 * Set the date to invalid.
 	 */
-	void clear()
+	constexpr void clear()
 	{
 		m_Julian = 0;
 	}
@@ -162,7 +353,7 @@ public:
 	/**
 	 * Get the julian day (not julian date)
 	 */
-	long GetJulianDay() const
+	constexpr long GetJulianDay() const
 	{
 		return m_Julian;
 	}
@@ -170,7 +361,7 @@ public:
 	/**
 	 * Set the julian day (not julian date)
 	 */
-	void SetJulianDay(long inJulian)
+	constexpr void SetJulianDay(long inJulian)
 	{
 		if (0 < inJulian)
 			m_Julian = inJulian;
@@ -184,9 +375,23 @@ public:
 	 * @param bClearOnError If the input date is bad, clear the existing date.
 	 * @return Whether date was set (invalid date fails)
 	 */
-	bool SetDate(int inYr, int inMon, int inDay, bool bClearOnError = true);
+	constexpr bool SetDate(int inYr, int inMon, int inDay, bool bClearOnError = true)
+	{
+		// Round trip to reject days past the end of the month.
+		long julian = GregorianToSdn(inYr, inMon, inDay);
+		int yr = 0, mon = 0, day = 0;
+		SdnToGregorian(julian, yr, mon, day);
+		if (yr != inYr || mon != inMon || day != inDay)
+		{
+			if (bClearOnError)
+				m_Julian = 0;
+			return false;
+		}
+		m_Julian = julian;
+		return true;
+	}
 
-	ARBDate& operator=(ARBDate const& rhs)
+	constexpr ARBDate& operator=(ARBDate const& rhs)
 	{
 		if (this != &rhs)
 		{
@@ -194,7 +399,7 @@ public:
 		}
 		return *this;
 	}
-	ARBDate& operator=(ARBDate&& rhs)
+	constexpr ARBDate& operator=(ARBDate&& rhs)
 	{
 		if (this != &rhs)
 		{
@@ -202,73 +407,73 @@ public:
 		}
 		return *this;
 	}
-	bool operator==(ARBDate const& rhs) const
+	constexpr bool operator==(ARBDate const& rhs) const
 	{
 		return m_Julian == rhs.m_Julian;
 	}
-	bool operator!=(ARBDate const& rhs) const
+	constexpr bool operator!=(ARBDate const& rhs) const
 	{
 		return m_Julian != rhs.m_Julian;
 	}
-	bool operator<(ARBDate const& rhs) const
+	constexpr bool operator<(ARBDate const& rhs) const
 	{
 		return m_Julian < rhs.m_Julian;
 	}
-	bool operator>(ARBDate const& rhs) const
+	constexpr bool operator>(ARBDate const& rhs) const
 	{
 		return m_Julian > rhs.m_Julian;
 	}
-	bool operator<=(ARBDate const& rhs) const
+	constexpr bool operator<=(ARBDate const& rhs) const
 	{
 		return m_Julian <= rhs.m_Julian;
 	}
-	bool operator>=(ARBDate const& rhs) const
+	constexpr bool operator>=(ARBDate const& rhs) const
 	{
 		return m_Julian >= rhs.m_Julian;
 	}
-	long operator-(ARBDate const& rhs) const
+	constexpr long operator-(ARBDate const& rhs) const
 	{
 		return m_Julian - rhs.m_Julian;
 	}
-	ARBDate& operator++() // prefix
+	constexpr ARBDate& operator++() // prefix
 	{
 		++m_Julian;
 		return *this;
 	}
-	ARBDate operator++(int) // postfix
+	constexpr ARBDate operator++(int) // postfix
 	{
 		ARBDate tmp(*this);
 		++m_Julian;
 		return tmp;
 	}
-	ARBDate& operator--() // prefix
+	constexpr ARBDate& operator--() // prefix
 	{
 		--m_Julian;
 		return *this;
 	}
-	ARBDate operator--(int) // postfix
+	constexpr ARBDate operator--(int) // postfix
 	{
 		ARBDate tmp(*this);
 		--m_Julian;
 		return tmp;
 	}
-	ARBDate& operator+=(int inD)
+	constexpr ARBDate& operator+=(int inD)
 	{
 		m_Julian += inD;
 		return *this;
 	}
-	ARBDate& operator-=(int inD)
+	constexpr ARBDate& operator-=(int inD)
 	{
 		m_Julian -= inD;
 		return *this;
 	}
-	ARBDate operator+(int inD) const
+	constexpr ARBDate operator+(int inD) const
 	{
 		ARBDate d;
 		d.SetJulianDay(m_Julian + inD);
 		return d;
 	}
-	ARBDate operator-(int inD) const
+	constexpr ARBDate operator-(int inD) const
 	{
 		ARBDate d;
 		d.SetJulianDay(m_Julian - inD);
@@ -278,14 +483,14 @@ public:
 	/**
 	 * Test if date is between two dates (inclusive)
 	 */
-	bool isBetween(ARBDate const& inDate1, ARBDate const& inDate2) const
+	constexpr bool isBetween(ARBDate const& inDate1, ARBDate const& inDate2) const
 	{
 		if (inDate1 > inDate2)
 			return isBetween(inDate2, inDate1);
 		return m_Julian >= inDate1.m_Julian && m_Julian <= inDate2.m_Julian;
 	}
 
-	bool isLeap() const ///< Is this a leap year?
+	constexpr bool isLeap() const ///< Is this a leap year?
 	{
 		int yr = GetYear();
 		return ((yr & 3) == 0 && yr % 100 != 0) || yr % 400 == 0;
@@ -299,13 +504,35 @@ public:
 	 */
 	wxString GetString(ARBDateFormat inFormat = ARBDateFormat::Locale, bool inForceOutput = false) const;
 
+	/**
+	 * Append the date to a string (see GetString).
+	 * Numeric formats are written directly, without using wxDateTime.
+	 */
+	void AppendTo(wxString& ioString, ARBDateFormat inFormat = ARBDateFormat::Locale, bool inForceOutput = false)
+		const;
+
+	/// Buffer size needed by FormatTo.
+	static constexpr size_t MaxFormatLength = 20;
+
+	/**
+	 * Format the date without allocating. Only numeric formats are supported.
+	 * @param outBuffer At least MaxFormatLength characters (not terminated).
+	 * @param inFormat Format of date string.
+	 * @return Number of characters written, 0 if the date is not valid or
+	 *         the format is Locale or Verbose.
+	 */
+	size_t FormatTo(char* outBuffer, ARBDateFormat inFormat) const;
+
 	/**
 	 * Get the current date.
 	 * @param outYr Current year.
 	 * @param outMon Current month.
 	 * @param outDay Current day.
 	 */
-	void GetDate(int& outYr, int& outMon, int& outDay) const;
+	constexpr void GetDate(int& outYr, int& outMon, int& outDay) const
+	{
+		SdnToGregorian(m_Julian, outYr, outMon, outDay);
+	}
 
 	/**
 	 * Convert the date to a time.
@@ -330,20 +557,38 @@ public:
 	bool GetDate(wxDateTime& outDate) const;
 #endif
 
-	int GetDay() const;   ///< Get the current day.
-	int GetMonth() const; ///< Get the current month.
-	int GetYear() const;  ///< Get the current year.
+	constexpr int GetDay() const ///< Get the current day.
+	{
+		int yr = 0, mon = 0, day = 0;
+		SdnToGregorian(m_Julian, yr, mon, day);
+		return day;
+	}
+	constexpr int GetMonth() const ///< Get the current month.
+	{
+		int yr = 0, mon = 0, day = 0;
+		SdnToGregorian(m_Julian, yr, mon, day);
+		return mon;
+	}
+	constexpr int GetYear() const ///< Get the current year.
+	{
+		int yr = 0, mon = 0, day = 0;
+		SdnToGregorian(m_Julian, yr, mon, day);
+		return yr;
+	}
 
 	/**
 	 * Day of year (1-366)
 	 */
-	int GetDayOfYear() const;
+	constexpr int GetDayOfYear() const
+	{
+		return static_cast<int>(m_Julian - GregorianToSdn(GetYear(), 1, 1) + 1);
+	}
 
 	/**
 	 * Get the day of the week of the current date.
 	 * @param inFirstDay Define what day of week has index 0 (1st day of week).
 	 */
-	int GetDayOfWeek(ARBDayOfWeek inFirstDay = ARBDayOfWeek::Sunday) const
+	constexpr int GetDayOfWeek(ARBDayOfWeek inFirstDay = ARBDayOfWeek::Sunday) const
 	{
 		// This was copied from another source, but I don't remember where...
 		// I suspect it won't work properly on dates before 1752 (start of
@@ -353,8 +598,23 @@ public:
 	}
 
 private:
+	static constexpr long SDN_OFFSET = 32045;
+	static constexpr long DAYS_PER_5_MONTHS = 153;
+	static constexpr long DAYS_PER_4_YEARS = 1461;
+	static constexpr long DAYS_PER_400_YEARS = 146097;
+
 	long m_Julian; ///< Julian day, not Julian date.
 };
 
+
+/**
+ * Number of dates in a calendar period (see ARBDate::CountByPeriod)
+ */
+struct ARBDatePeriodCount
+{
+	ARBDate start; ///< First day of the period
+	size_t count;  ///< Number of dates in the period
+};
+
 } // namespace ARBCommon
 } // namespace dconSoft
@@ -0,0 +1,291 @@
+#pragma once
+
+/*
+ * Copyright (c) David Connet. All Rights Reserved.
+ *
+ * License: See License.txt
+ */
+
+/**
+ * @file
+ * @brief Index of date ranges for containment and overlap queries.
+ * @author David Connet
+ *
+ * The ranges are kept in an array sorted by start date. The array is treated
+ * as an implicit balanced tree (the middle of a range is its root) and each
+ * node records the latest end date in its subtree, so a query skips every
+ * subtree that ends before the query starts or begins after it ends.
+ * Inserts go to a small unsorted list that is merged into the array once it
+ * grows; removes mark entries and the array is compacted once a quarter of
+ * it is dead.
+ *
+ * Revision History
+ * 2026-10-19 Created
+ */
+
+#include "ARBDate.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+#include <vector>
+
+
+namespace dconSoft
+{
+namespace ARBCommon
+{
+
+/**
+ * Index of [from, to] date ranges, each with a value.
+ * As with ARBDate::isBetween, both ends are inclusive and a reversed range is
+ * treated as if its ends were swapped. An invalid date makes that end of a
+ * range open (as in ARBDate::GetValidDateString).
+ * Queries only descend into subtrees that hold a match: O(log n) when there
+ * is none, at worst O(log n) per match (plus a scan of any ranges added
+ * since the last merge, see Insert).
+ */
+template <typename T> class ARBDateIntervalIndex
+{
+public:
+	struct Interval
+	{
+		ARBDate from;
+		ARBDate to;
+		T value;
+	};
+
+	ARBDateIntervalIndex()
+		: m_entries()
+		, m_maxTo()
+		, m_pending()
+		, m_removed(0)
+	{
+	}
+
+	/**
+	 * Replace the contents of the index.
+	 * Bulk building is O(n log n), much faster than inserting one at a time.
+	 */
+	void Build(std::vector<Interval> const& inIntervals)
+	{
+		clear();
+		m_entries.reserve(inIntervals.size());
+		for (auto const& interval : inIntervals)
+			m_entries.push_back(MakeEntry(interval.from, interval.to, interval.value));
+		std::sort(m_entries.begin(), m_entries.end(), LessFrom);
+		ComputeMaxTo();
+	}
+
+	/// Number of ranges in the index.
+	size_t size() const
+	{
+		return m_entries.size() - m_removed + m_pending.size();
+	}
+	bool empty() const
+	{
+		return 0 == size();
+	}
+	void clear()
+	{
+		m_entries.clear();
+		m_maxTo.clear();
+		m_pending.clear();
+		m_removed = 0;
+	}
+
+	/**
+	 * Add a range.
+	 * New ranges are held aside (and scanned linearly by queries) until
+	 * there are about sqrt(n) of them, then merged into the index.
+	 */
+	void Insert(ARBDate const& inFrom, ARBDate const& inTo, T const& inValue)
+	{
+		m_pending.push_back(MakeEntry(inFrom, inTo, inValue));
+		if (m_pending.size() > MaxPending())
+			Merge();
+	}
+
+	/**
+	 * Remove one range that matches all of the arguments.
+	 * @return Whether a range was found.
+	 */
+	bool Remove(ARBDate const& inFrom, ARBDate const& inTo, T const& inValue)
+	{
+		Entry key = MakeEntry(inFrom, inTo, inValue);
+		for (auto iter = m_pending.begin(); iter != m_pending.end(); ++iter)
+		{
+			if (iter->from == key.from && iter->to == key.to && iter->value == inValue)
+			{
+				*iter = std::move(m_pending.back());
+				m_pending.pop_back();
+				return true;
+			}
+		}
+		auto range = std::equal_range(m_entries.begin(), m_entries.end(), key, LessFrom);
+		for (auto iter = range.first; iter != range.second; ++iter)
+		{
+			if (!iter->removed && iter->to == key.to && iter->value == inValue)
+			{
+				// Leave m_maxTo alone: a stale (larger) end only costs a
+				// little pruning until the next compaction.
+				iter->removed = true;
+				if (++m_removed > m_entries.size() / 4)
+					Merge();
+				return true;
+			}
+		}
+		return false;
+	}
+
+	/**
+	 * Call 'func(value)' for every range that includes a date.
+	 * An invalid date matches nothing.
+	 */
+	template <typename FUNC> void ForEachContaining(ARBDate const& inDate, FUNC const& func) const
+	{
+		if (inDate.IsValid())
+			ForEach(inDate.GetJulianDay(), inDate.GetJulianDay(), func);
+	}
+
+	/**
+	 * Call 'func(value)' for every range that overlaps [from, to].
+	 * The query range follows the same rules as the indexed ranges.
+	 */
+	template <typename FUNC> void ForEachOverlapping(ARBDate const& inFrom, ARBDate const& inTo, FUNC const& func) const
+	{
+		long from, to;
+		GetRange(inFrom, inTo, from, to);
+		ForEach(from, to, func);
+	}
+
+	/// Values of all ranges that include a date (in no particular order).
+	std::vector<T> FindContaining(ARBDate const& inDate) const
+	{
+		std::vector<T> values;
+		ForEachContaining(inDate, [&values](T const& value) { values.push_back(value); });
+		return values;
+	}
+
+	/// Values of all ranges that overlap [from, to] (in no particular order).
+	std::vector<T> FindOverlapping(ARBDate const& inFrom, ARBDate const& inTo) const
+	{
+		std::vector<T> values;
+		ForEachOverlapping(inFrom, inTo, [&values](T const& value) { values.push_back(value); });
+		return values;
+	}
+
+private:
+	struct Entry
+	{
+		long from;
+		long to;
+		T value;
+		bool removed;
+	};
+
+	static bool LessFrom(Entry const& inEntry1, Entry const& inEntry2)
+	{
+		return inEntry1.from < inEntry2.from;
+	}
+
+	static void GetRange(ARBDate const& inFrom, ARBDate const& inTo, long& outFrom, long& outTo)
+	{
+		ARBDate from(inFrom);
+		ARBDate to(inTo);
+		if (from.IsValid() && to.IsValid() && from > to)
+			std::swap(from, to);
+		outFrom = from.IsValid() ? from.GetJulianDay() : std::numeric_limits<long>::min();
+		outTo = to.IsValid() ? to.GetJulianDay() : std::numeric_limits<long>::max();
+	}
+
+	static Entry MakeEntry(ARBDate const& inFrom, ARBDate const& inTo, T const& inValue)
+	{
+		Entry entry{0, 0, inValue, false};
+		GetRange(inFrom, inTo, entry.from, entry.to);
+		return entry;
+	}
+
+	size_t MaxPending() const
+	{
+		return std::max<size_t>(64, static_cast<size_t>(std::sqrt(static_cast<double>(m_entries.size()))));
+	}
+
+	// Drop removed entries and merge in the pending ones.
+	void Merge()
+	{
+		if (0 < m_removed)
+		{
+			m_entries.erase(
+				std::remove_if(m_entries.begin(), m_entries.end(), [](Entry const& entry) { return entry.removed; }),
+				m_entries.end());
+			m_removed = 0;
+		}
+		if (!m_pending.empty())
+		{
+			std::sort(m_pending.begin(), m_pending.end(), LessFrom);
+			size_t n = m_entries.size();
+			m_entries.insert(
+				m_entries.end(),
+				std::make_move_iterator(m_pending.begin()),
+				std::make_move_iterator(m_pending.end()));
+			m_pending.clear();
+			std::inplace_merge(m_entries.begin(), m_entries.begin() + n, m_entries.end(), LessFrom);
+		}
+		ComputeMaxTo();
+	}
+
+	void ComputeMaxTo()
+	{
+		m_maxTo.resize(m_entries.size());
+		ComputeMaxTo(0, m_entries.size());
+	}
+
+	long ComputeMaxTo(size_t inLo, size_t inHi)
+	{
+		if (inLo >= inHi)
+			return std::numeric_limits<long>::min();
+		size_t mid = inLo + (inHi - inLo) / 2;
+		long maxTo = std::max(ComputeMaxTo(inLo, mid), ComputeMaxTo(mid + 1, inHi));
+		m_maxTo[mid] = std::max(maxTo, m_entries[mid].to);
+		return m_maxTo[mid];
+	}
+
+	template <typename FUNC> void ForEach(long inFrom, long inTo, FUNC const& func) const
+	{
+		ForEach(0, m_entries.size(), inFrom, inTo, func);
+		for (auto const& entry : m_pending)
+		{
+			if (entry.from <= inTo && inFrom <= entry.to)
+				func(entry.value);
+		}
+	}
+
+	template <typename FUNC> void ForEach(size_t inLo, size_t inHi, long inFrom, long inTo, FUNC const& func) const
+	{
+		while (inLo < inHi)
+		{
+			size_t mid = inLo + (inHi - inLo) / 2;
+			// Nothing in this subtree ends late enough.
+			if (m_maxTo[mid] < inFrom)
+				return;
+			ForEach(inLo, mid, inFrom, inTo, func);
+			// Everything from here on starts too late.
+			Entry const& entry = m_entries[mid];
+			if (entry.from > inTo)
+				return;
+			if (!entry.removed && inFrom <= entry.to)
+				func(entry.value);
+			inLo = mid + 1;
+		}
+	}
+
+	std::vector<Entry> m_entries; ///< Sorted by 'from'
+	std::vector<long> m_maxTo;    ///< Latest 'to' in the subtree rooted at each entry
+	std::vector<Entry> m_pending; ///< Inserted since the last merge (unsorted)
+	size_t m_removed;             ///< Entries in m_entries marked as removed
+};
+
+} // namespace ARBCommon
+} // namespace dconSoft
@@ -11,6 +11,10 @@
  * @brief File hashing algorithms
  *
  * Revision History
+ * 2026-10-19 Added Compute(filename) and a configurable stream buffer.
+ * 2026-10-19 Added SHA384, SHA512 and XXH64.
+ * 2026-10-19 Added computing several digests in one pass.
+ * 2026-10-19 Added ComputeMany for hashing batches of files in parallel.
  * 2013-10-29 Added sha1/sha256
  * 2012-04-10 Based on wx-group thread, use std::string for internal use
  * 2010-02-07 Created
@@ -19,6 +23,9 @@
 #include "LibwxARBCommon.h"
 
 #include <istream>
+#include <map>
+#include <set>
+#include <vector>
 
 
 namespace dconSoft
@@ -34,9 +41,101 @@ enum class ARBDigest
 	MD5,
 	SHA1,
 	SHA256,
+	SHA384,
+	SHA512, ///< Faster than SHA256 on 64bit machines.
+	XXH64,  ///< Fast, non-cryptographic. Only use for change detection.
 };
 
-ARBCOMMON_API wxString Compute(std::istream& inFile, ARBDigest type, size_t* outSize = nullptr);
+/// Default read size when hashing a stream.
+constexpr size_t DefaultStreamBufferSize = 64 * 1024;
+
+/**
+ * Compute the digest of a stream.
+ * @param inFile Data to hash.
+ * @param type Digest algorithm.
+ * @param outSize Number of bytes hashed.
+ * @param inBufferSize Size of each read from the stream.
+ * @return Digest, empty on failure.
+ */
+ARBCOMMON_API wxString Compute(
+	std::istream& inFile,
+	ARBDigest type,
+	size_t* outSize = nullptr,
+	size_t inBufferSize = DefaultStreamBufferSize);
+
+/**
+ * Compute the digest of a file.
+ * On Windows, regular files are memory mapped and hashed in place (Windows
+ * won't truncate a file while it is mapped). Elsewhere, and for other files,
+ * the file is read in large blocks: mapping would make a file truncated by
+ * another process while it's being hashed kill this one (SIGBUS) rather
+ * than just end early. Either way this is much faster than the stream
+ * version.
+ * @param inFileName File to hash.
+ * @param type Digest algorithm.
+ * @param outSize Number of bytes hashed.
+ * @return Digest, empty on failure.
+ */
+ARBCOMMON_API wxString Compute(wxString const& inFileName, ARBDigest type, size_t* outSize = nullptr);
+
+/**
+ * Compute several digests while reading the data only once.
+ * @param inFile Data to hash.
+ * @param types Digest algorithms to compute.
+ * @param outSize Number of bytes hashed.
+ * @param bThreaded Run each algorithm on its own thread, sharing read buffers.
+ * @return Digest for each requested algorithm.
+ */
+ARBCOMMON_API std::map<ARBDigest, wxString> Compute(
+	std::istream& inFile,
+	std::set<ARBDigest> const& types,
+	size_t* outSize = nullptr,
+	bool bThreaded = false);
+
+
+/**
+ * Why a digest in a batch could not be computed.
+ */
+enum class ARBDigestError
+{
+	None,       ///< Digest was computed
+	OpenFailed, ///< File could not be opened
+	ReadFailed, ///< An I/O error occurred while reading
+};
+
+/**
+ * Result of one entry in a batch digest computation.
+ */
+struct ARBDigestResult
+{
+	ARBDigestError error = ARBDigestError::None;
+	wxString digest;  ///< Empty on error
+	size_t size = 0;  ///< Number of bytes hashed
+};
+
+/**
+ * Compute the digest of a number of files concurrently.
+ * @param inFiles Files to hash.
+ * @param type Digest algorithm.
+ * @param nThreads Maximum number of worker threads (0: number of cores).
+ * @return One result per input file, in the same order as inFiles.
+ */
+ARBCOMMON_API std::vector<ARBDigestResult> ComputeMany(
+	std::vector<wxString> const& inFiles,
+	ARBDigest type,
+	size_t nThreads = 0);
+
+/**
+ * Compute the digest of a number of streams concurrently.
+ * @param inStreams Streams to hash. Each stream must be a distinct object.
+ * @param type Digest algorithm.
+ * @param nThreads Maximum number of worker threads (0: number of cores).
+ * @return One result per input stream, in the same order as inStreams.
+ */
+ARBCOMMON_API std::vector<ARBDigestResult> ComputeMany(
+	std::vector<std::istream*> const& inStreams,
+	ARBDigest type,
+	size_t nThreads = 0);
 
 } // namespace ARBMsgDigest
 } // namespace ARBCommon
@@ -0,0 +1,92 @@
+#pragma once
+
+/*
+ * Copyright (c) David Connet. All Rights Reserved.
+ *
+ * License: See License.txt
+ */
+
+/**
+ * @file
+ * @brief Persistent cache of file digests
+ * @author David Connet
+ *
+ * A digest is reused as long as the file's size, modification time and
+ * file id (inode) are unchanged, so re-scanning untouched files does no I/O
+ * beyond a stat.
+ *
+ * The cache file is an append-only journal. Several processes may share
+ * one cache file: all access is serialized with an OS file lock on
+ * "<cacheFile>.lock", new entries are appended by Flush() and entries
+ * written by other processes are picked up at that time. Compact()
+ * rewrites the journal without duplicate or stale entries.
+ *
+ * Revision History
+ * 2026-10-19 Created
+ */
+
+#include "ARBMsgDigest.h"
+
+
+namespace dconSoft
+{
+namespace ARBCommon
+{
+namespace ARBMsgDigest
+{
+
+class ARBCOMMON_API ARBDigestCache
+{
+	DECLARE_NO_COPY_IMPLEMENTED(ARBDigestCache)
+public:
+	/**
+	 * Open (or create) a digest cache.
+	 * @param inCacheFile Journal file. It is read immediately.
+	 */
+	explicit ARBDigestCache(wxString const& inCacheFile);
+	/// Flushes any new entries.
+	~ARBDigestCache();
+
+	/**
+	 * Get a cached digest without computing it.
+	 * @param inFileName File to look up.
+	 * @param type Digest algorithm.
+	 * @param outDigest Cached digest.
+	 * @param outSize Size of the file.
+	 * @return Whether the file has a cached digest that is still valid.
+	 */
+	bool Lookup(wxString const& inFileName, ARBDigest type, wxString& outDigest, size_t* outSize = nullptr) const;
+
+	/**
+	 * Get the digest of a file, computing (and caching) it if needed.
+	 * This is safe to call from several threads.
+	 * @param inFileName File to hash.
+	 * @param type Digest algorithm.
+	 * @param outSize Number of bytes in the file.
+	 * @return Digest, empty on failure.
+	 */
+	wxString Compute(wxString const& inFileName, ARBDigest type, size_t* outSize = nullptr);
+
+	/**
+	 * Append new entries to the journal and load entries added by others.
+	 * @return Success
+	 */
+	bool Flush();
+
+	/**
+	 * Rewrite the journal, dropping superseded entries and entries for files
+	 * that are gone or have changed.
+	 * @return Success
+	 */
+	bool Compact();
+
+	/// Number of cached entries.
+	size_t size() const;
+
+private:
+	class ARBDigestCacheImpl* m_pImpl;
+};
+
+} // namespace ARBMsgDigest
+} // namespace ARBCommon
+} // namespace dconSoft
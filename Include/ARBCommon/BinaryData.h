@@ -12,6 +12,9 @@
  * @author David Connet
  *
  * Revision History
+ * 2026-10-19 Added size hints, DecodeInto and a reusable CDecodeContext.
+ * 2026-10-19 Added compression level, parallel EncodeFile.
+ * 2026-10-19 Stream through zlib/base64, accept string_view/pointer input.
  * 2009-09-13 Add support for wxWidgets 2.9, deprecate tstring.
  * 2007-01-03 Created
  */
@@ -19,6 +22,9 @@
 #include "LibwxARBCommon.h"
 
 #include "ARBTypes.h"
+#include <memory>
+#include <string_view>
+#include <vector>
 
 
 namespace dconSoft
@@ -29,22 +35,95 @@ namespace BinaryData
 {
 /**
  * Decode base64 and decompress data.
+ * The data is streamed through the decoder and zlib, there are no
+ * intermediate copies.
  * @param inBase64 Base64 encoded data
  * @param outBinData Decoded/decompressed data
- * @post outBinData must be deallocated using Release()
+ * @param inSizeHint Expected decompressed size (0: unknown). The output is
+ *                   allocated once when this is exact; it still grows if the
+ *                   hint is too small.
  */
-ARBCOMMON_API bool Decode(std::string const& inBase64, std::vector<unsigned char>& outBinData);
+ARBCOMMON_API bool Decode(
+	std::string_view inBase64,
+	std::vector<unsigned char>& outBinData,
+	size_t inSizeHint = 0);
+
+/**
+ * Decode base64 and decompress data into a caller supplied buffer.
+ * The encoded format does not store the decompressed size, so the caller must
+ * know it (usually because it was saved alongside the data).
+ * @param inBase64 Base64 encoded data
+ * @param outBuffer Destination.
+ * @param inBufferSize Size of outBuffer.
+ * @param outSize Number of bytes written to outBuffer.
+ * @return Success. Fails if the decompressed data does not fit.
+ */
+ARBCOMMON_API bool DecodeInto(
+	std::string_view inBase64,
+	unsigned char* outBuffer,
+	size_t inBufferSize,
+	size_t& outSize);
+
+/**
+ * Reusable decoding state for decoding many (small) blobs.
+ * One zlib inflate stream is set up when the context is created and reset
+ * for each blob, and the compressed data is decoded into a buffer that is
+ * kept between calls, so a warm context does no allocations of its own
+ * (only growing the caller's output in Decode). Results are the same as the
+ * free functions. Not thread safe: use one per thread.
+ */
+class ARBCOMMON_API CDecodeContext
+{
+	DECLARE_NO_COPY_IMPLEMENTED(CDecodeContext)
+public:
+	CDecodeContext();
+	~CDecodeContext();
+
+	/// See BinaryData::Decode
+	bool Decode(std::string_view inBase64, std::vector<unsigned char>& outBinData, size_t inSizeHint = 0);
+	/// See BinaryData::DecodeInto
+	bool DecodeInto(std::string_view inBase64, unsigned char* outBuffer, size_t inBufferSize, size_t& outSize);
+
+private:
+	struct CInflater;
+	std::unique_ptr<CInflater> m_inflater;
+	std::vector<unsigned char> m_compressed;
+};
+
+/// zlib compression level: 0 (none) to 9 (best), -1 for zlib's default (6).
+constexpr int DefaultCompression = -1;
 
 /**
  * Compress and base64 encode a chunk of data.
+ * The data is streamed through zlib and the encoder, there are no
+ * intermediate copies.
  * @param inBinData Data to encode.
  * @param outBase64 Base64 encoded string of compressed (zlib) data.
+ * @param level Compression level.
+ */
+ARBCOMMON_API bool Encode(
+	std::vector<unsigned char> const& inBinData,
+	std::string& outBase64,
+	int level = DefaultCompression);
+ARBCOMMON_API bool Encode(void const* inData, size_t inLen, std::string& outBase64, int level = DefaultCompression);
+
+/**
+ * Compress and base64 encode a file.
+ * Large files are split into blocks that are compressed on several threads
+ * (like pigz) and joined into a single zlib stream.
+ * @param inFileName File to encode.
+ * @param outBase64 Base64 encoded string of compressed (zlib) data.
+ * @param level Compression level.
+ * @param nThreads Maximum number of threads (0: number of cores, 1: don't split).
  */
-ARBCOMMON_API bool Encode(std::vector<unsigned char> const& inBinData, std::string& outBase64);
-ARBCOMMON_API bool EncodeFile(wxString const& inFileName, std::string& outBase64);
+ARBCOMMON_API bool EncodeFile(
+	wxString const& inFileName,
+	std::string& outBase64,
+	int level = DefaultCompression,
+	size_t nThreads = 0);
 
-ARBCOMMON_API bool DecodeString(std::string const& inBase64, std::string& outData);
-ARBCOMMON_API bool EncodeString(std::string const& inData, std::string& outBase64);
+ARBCOMMON_API bool DecodeString(std::string_view inBase64, std::string& outData);
+ARBCOMMON_API bool EncodeString(std::string_view inData, std::string& outBase64);
 } // namespace BinaryData
 } // namespace ARBCommon
 } // namespace dconSoft
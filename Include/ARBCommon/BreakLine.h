@@ -12,12 +12,15 @@
  * @author David Connet
  *
  * Revision History
+ * 2026-10-19 Added string_view BreakLine and ForEachField.
+ * 2026-10-19 Added appending WriteCSVField.
  * 2020-11-12 Added option to force quotes on writing CSV.
  * 2010-10-30 Moved BreakLine from Globals.h, added CSV routines.
  */
 
 #include "LibwxARBCommon.h"
 
+#include <string_view>
 #include <vector>
 
 
@@ -39,6 +42,48 @@ namespace ARBCommon
 ARBCOMMON_API size_t
 BreakLine(wchar_t inSep, wxString const& inStr, std::vector<wxString>& outFields, bool inRemoveEmpties = false);
 
+/**
+ * Separate a line into substrings without copying them.
+ * The fields point into inStr. outFields is cleared first but keeps its
+ * capacity, so reusing it in a loop does not allocate.
+ * A wxString can be passed as std::wstring_view(str.wc_str(), str.length()).
+ * @param inSep Separator character
+ * @param inStr String to separate
+ * @param outFields Separated pieces
+ * @param inRemoveEmpties Remove any empty subfields
+ * @return Number of fields parsed.
+ * @note Return value may be larger than vector size due to removed entries.
+ */
+ARBCOMMON_API size_t BreakLine(
+	wchar_t inSep,
+	std::wstring_view inStr,
+	std::vector<std::wstring_view>& outFields,
+	bool inRemoveEmpties = false);
+
+/**
+ * Call a function for each field in a line, without copying.
+ * @param inSep Separator character
+ * @param inStr String to separate
+ * @param func Called with each field (std::wstring_view), in order. Return
+ *             false to stop.
+ * @return Number of fields visited.
+ */
+template <typename FUNC> size_t ForEachField(wchar_t inSep, std::wstring_view inStr, FUNC const& func)
+{
+	if (inStr.empty())
+		return 0;
+	size_t fld = 0;
+	for (;;)
+	{
+		size_t pos = inStr.find(inSep);
+		++fld;
+		if (!func(inStr.substr(0, pos)) || std::wstring_view::npos == pos)
+			break;
+		inStr.remove_prefix(pos + 1);
+	}
+	return fld;
+}
+
 
 enum class ReadStatus
 {
@@ -84,5 +129,15 @@ ARBCOMMON_API wxString WriteCSV(wchar_t inSep, std::vector<wxString> const& inFi
  */
 ARBCOMMON_API wxString WriteCSVField(wchar_t inSep, wxString const& inField, bool includeQuote = false);
 
+/**
+ * Append a field for a CSV file [Based on RFC 4180 (October 2005)]
+ * For writing large amounts of data, see CsvWriter.
+ * @param inSep Separator character
+ * @param inField Fields to write
+ * @param includeQuote Always quote the output field
+ * @param ioOutput The field is appended to this.
+ */
+ARBCOMMON_API void WriteCSVField(wchar_t inSep, wxString const& inField, bool includeQuote, wxString& ioOutput);
+
 } // namespace ARBCommon
 } // namespace dconSoft
@@ -0,0 +1,208 @@
+#pragma once
+
+/*
+ * Copyright (c) David Connet. All Rights Reserved.
+ *
+ * License: See License.txt
+ */
+
+/**
+ * @file
+ * @brief Streaming CSV reader [Based on RFC 4180 (October 2005)]
+ * @author David Connet
+ *
+ * The reader works on 8bit (UTF-8) data. Records end with LF or CRLF. Quoted
+ * fields may contain separators, newlines and doubled quotes. A CRLF inside a
+ * quoted field is returned as LF. A leading UTF-8 BOM is skipped.
+ * Quoting rules are the same as ReadCSV: a quote in an unquoted field, or
+ * anything but a separator or newline after a closing quote, is an error.
+ * An empty line is a row with no fields.
+ *
+ * Revision History
+ * 2026-10-19 Report stream failures (IsReadError, GetResult).
+ * 2026-10-19 Added multi-threaded ReadCsvRows/ReadCsvFile.
+ * 2026-10-19 Created
+ */
+
+#include "LibwxARBCommon.h"
+
+#include <functional>
+#include <istream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+namespace dconSoft
+{
+namespace ARBCommon
+{
+
+enum class CsvResult
+{
+	Ok,       ///< All rows were read
+	Error,    ///< Data was ill-formed (quoting) or could not be read
+	Canceled, ///< The progress callback canceled the import
+};
+
+
+/**
+ * Read rows from a CSV stream or memory buffer.
+ *
+ * Fields are views: into the input when the field needs no unescaping,
+ * otherwise into a buffer owned by the reader. They are valid until the next
+ * call to ReadRow. All buffers are reused, so reading a file does not
+ * allocate per row.
+ *
+ * @code
+ * CsvReader reader(stream, ';');
+ * while (reader.ReadRow())
+ * {
+ *     for (auto field : reader.Fields())
+ *         ...
+ * }
+ * if (reader.IsError())
+ *     ... reader.GetLineNumber(), reader.IsReadError() ...
+ * @endcode
+ */
+class ARBCOMMON_API CsvReader
+{
+	DECLARE_NO_COPY_IMPLEMENTED(CsvReader)
+public:
+	/**
+	 * Read from a stream. The stream is read in chunks as needed.
+	 * @param inStream Input, must outlive the reader.
+	 * @param inSep Separator character.
+	 */
+	explicit CsvReader(std::istream& inStream, char inSep = ',');
+	/**
+	 * Read from memory. The data is not copied.
+	 * @param inData Input, must outlive the reader.
+	 * @param inSep Separator character.
+	 */
+	explicit CsvReader(std::string_view inData, char inSep = ',');
+	~CsvReader();
+
+	/**
+	 * Parse the next row.
+	 * @return False at the end of the data or on an error (see IsError).
+	 */
+	bool ReadRow();
+
+	/// Fields of the current row.
+	std::vector<std::string_view> const& Fields() const
+	{
+		return m_fields;
+	}
+
+	/// Did reading stop because of ill-formed data (quoting) or a stream failure?
+	bool IsError() const
+	{
+		return m_bError;
+	}
+
+	/// Did the stream fail (as opposed to ill-formed data)?
+	bool IsReadError() const
+	{
+		return m_bReadError;
+	}
+
+	/// Ok, or Error if reading stopped early (see IsError).
+	CsvResult GetResult() const
+	{
+		return m_bError ? CsvResult::Error : CsvResult::Ok;
+	}
+
+	/// Line (1-based) the current row (or the error) starts on.
+	size_t GetLineNumber() const
+	{
+		return m_line;
+	}
+
+private:
+	enum class ParseStatus
+	{
+		Ok,
+		NeedMore,
+		Error,
+	};
+	void SkipBOM();
+	ParseStatus ParseRow(char const*& ioPos, char const* end, size_t& outLines);
+	bool Fill();
+
+	// Where a field's text is. Fields copied into m_scratch are resolved to
+	// views after the row is done (the scratch may reallocate while parsing).
+	struct FieldSpan
+	{
+		char const* ptr; ///< nullptr: 'offset' is in m_scratch
+		size_t offset;
+		size_t length;
+	};
+
+	std::istream* m_stream;
+	char m_sep;
+	std::vector<char> m_buffer;
+	char const* m_data;
+	size_t m_pos;
+	size_t m_end;
+	bool m_bEof;
+	bool m_bError;
+	bool m_bReadError;
+	size_t m_line;
+	size_t m_nextLine;
+	std::string m_scratch;
+	std::vector<FieldSpan> m_spans;
+	std::vector<std::string_view> m_fields;
+};
+
+
+/**
+ * Progress of a CSV import: bytes parsed so far and total bytes.
+ * It is only called on the thread that started the import, so it may update
+ * UI. For example, with an IDlgProgress:
+ * @code
+ * progress->SetRange(1, 100);
+ * auto callback = [progress](size_t done, size_t total) {
+ *     progress->SetPos(1, static_cast<int>(done * 100 / total));
+ *     return !progress->HasCanceled();
+ * };
+ * @endcode
+ * @return False to cancel.
+ */
+using CsvProgress = std::function<bool(size_t done, size_t total)>;
+
+/**
+ * Read all rows of CSV data, using several threads for large data.
+ * The data is split into chunks. Record boundaries are found by tracking
+ * quote parity (so quoted fields with newlines are handled), then the
+ * chunks are parsed concurrently. Rows and errors are exactly what a
+ * CsvReader would produce.
+ * @param inData CSV data.
+ * @param inSep Separator character.
+ * @param outRows Rows in their original order (cleared on failure).
+ * @param nThreads Maximum number of threads (0: number of cores).
+ * @param inProgress Progress callback (optional).
+ * @param outErrorLine Line (1-based) of the first ill-formed row.
+ * @return Result of the import.
+ */
+ARBCOMMON_API CsvResult ReadCsvRows(
+	std::string_view inData,
+	char inSep,
+	std::vector<std::vector<std::string>>& outRows,
+	size_t nThreads = 0,
+	CsvProgress const& inProgress = CsvProgress(),
+	size_t* outErrorLine = nullptr);
+
+/**
+ * Read all rows of a CSV file. See ReadCsvRows.
+ */
+ARBCOMMON_API CsvResult ReadCsvFile(
+	wxString const& inFileName,
+	char inSep,
+	std::vector<std::vector<std::string>>& outRows,
+	size_t nThreads = 0,
+	CsvProgress const& inProgress = CsvProgress(),
+	size_t* outErrorLine = nullptr);
+
+} // namespace ARBCommon
+} // namespace dconSoft
@@ -0,0 +1,176 @@
+#pragma once
+
+/*
+ * Copyright (c) David Connet. All Rights Reserved.
+ *
+ * License: See License.txt
+ */
+
+/**
+ * @file
+ * @brief Columnar, typed CSV import
+ * @author David Connet
+ *
+ * Column types are inferred from a sample of rows: integer, double, date
+ * (in a given ARBDateFormat) or string. Values are then parsed straight into
+ * typed column vectors. String columns are dictionary encoded: each distinct
+ * value is stored once and rows hold a 32bit code.
+ *
+ * Revision History
+ * 2026-10-19 Widen a column in place instead of importing again.
+ * 2026-10-19 Created
+ */
+
+#include "ARBDate.h"
+#include "CsvReader.h"
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+
+namespace dconSoft
+{
+namespace ARBCommon
+{
+
+enum class CsvColumnType
+{
+	Integer, ///< 64bit integers
+	Double,  ///< Floating point numbers ('.' decimal point)
+	Date,    ///< Dates
+	String,  ///< Anything else
+};
+
+
+/**
+ * One column of a CsvTable.
+ * Empty cells are allowed in any column (see IsEmpty). Accessing a value
+ * with the wrong type for the column asserts and returns an empty value.
+ */
+class ARBCOMMON_API CsvColumn
+{
+public:
+	CsvColumn(CsvColumn const&) = delete;
+	CsvColumn(CsvColumn&&) = default;
+	CsvColumn& operator=(CsvColumn const&) = delete;
+	CsvColumn& operator=(CsvColumn&&) = default;
+
+	/// Header text (empty if the data had no header).
+	std::string const& GetName() const
+	{
+		return m_name;
+	}
+	CsvColumnType GetType() const
+	{
+		return m_type;
+	}
+	/// Number of rows.
+	size_t size() const
+	{
+		return m_empty.size();
+	}
+	/// Was the cell empty?
+	bool IsEmpty(size_t inRow) const
+	{
+		return m_empty[inRow];
+	}
+
+	/// Integer column.
+	int64_t GetInteger(size_t inRow) const;
+	/// Integer or Double column.
+	double GetDouble(size_t inRow) const;
+	/// Date column.
+	ARBDate GetDate(size_t inRow) const;
+	/// String column.
+	std::string_view GetString(size_t inRow) const;
+
+	/// String column: dictionary code of a row.
+	uint32_t GetCode(size_t inRow) const;
+	/// String column: number of distinct values.
+	size_t GetDictionarySize() const
+	{
+		return m_dictionary.size();
+	}
+	/// String column: value of a code.
+	std::string_view GetDictionaryEntry(uint32_t inCode) const
+	{
+		return m_dictionary[inCode];
+	}
+
+private:
+	friend class CsvTable;
+	CsvColumn(std::string_view inName, CsvColumnType inType);
+	bool Add(std::string_view inField, ARBDateFormat inDateFormat);
+	void AddEmpty();
+	void ChangeToDouble();
+
+	std::string m_name;
+	CsvColumnType m_type;
+	std::vector<bool> m_empty;
+	std::vector<int64_t> m_integers; ///< Integer values, julian days for dates
+	std::vector<double> m_doubles;
+	std::vector<uint32_t> m_codes;
+	std::deque<std::string> m_dictionary; ///< Stable addresses for m_lookup
+	std::unordered_map<std::string_view, uint32_t> m_lookup;
+};
+
+
+/**
+ * CSV data, stored by column.
+ */
+class ARBCOMMON_API CsvTable
+{
+	DECLARE_NO_COPY_IMPLEMENTED(CsvTable)
+public:
+	CsvTable();
+	~CsvTable();
+
+	/**
+	 * Import CSV data, replacing any current data.
+	 * Column types are inferred from the first rows. If a later value does
+	 * not fit, that column is changed to a more general type and the import
+	 * continues: integers are converted to doubles, a change to string reads
+	 * that column's earlier values again.
+	 * Rows with fewer fields have empty cells. Extra fields in a row add
+	 * string columns.
+	 * @param inData CSV data (UTF-8).
+	 * @param inSep Separator character.
+	 * @param inHasHeader The first row contains column names.
+	 * @param inDateFormat Format of date columns.
+	 * @param outErrorLine Line (1-based) of ill-formed data.
+	 * @return Ok or Error.
+	 */
+	CsvResult Read(
+		std::string_view inData,
+		char inSep,
+		bool inHasHeader,
+		ARBDateFormat inDateFormat = ARBDateFormat::ISO,
+		size_t* outErrorLine = nullptr);
+
+	/// Number of rows (not including the header).
+	size_t GetRowCount() const
+	{
+		return m_rows;
+	}
+	size_t GetColumnCount() const
+	{
+		return m_columns.size();
+	}
+	CsvColumn const& GetColumn(size_t inColumn) const
+	{
+		return m_columns[inColumn];
+	}
+
+private:
+	void ChangeToString(std::string_view inData, char inSep, bool inHasHeader, size_t inColumn);
+
+	std::vector<CsvColumn> m_columns;
+	size_t m_rows;
+};
+
+} // namespace ARBCommon
+} // namespace dconSoft
@@ -0,0 +1,119 @@
+#pragma once
+
+/*
+ * Copyright (c) David Connet. All Rights Reserved.
+ *
+ * License: See License.txt
+ */
+
+/**
+ * @file
+ * @brief Buffered CSV writer [Based on RFC 4180 (October 2005)]
+ * @author David Connet
+ *
+ * Output is 8bit (UTF-8). A field is quoted when it contains the separator,
+ * a quote, CR or LF (or always, if requested). Quotes are doubled. Rows end
+ * with LF. A row whose only field is empty is written as "" (an empty line
+ * is a row with no fields). The output can be read back with CsvReader.
+ *
+ * Revision History
+ * 2026-10-19 Quote a row's only field when it is empty.
+ * 2026-10-19 Created
+ */
+
+#include "LibwxARBCommon.h"
+
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+namespace dconSoft
+{
+namespace ARBCommon
+{
+
+/**
+ * Write CSV rows to a stream or string.
+ *
+ * Fields are escaped directly into the output buffer, nothing is built per
+ * field or row.
+ *
+ * @code
+ * CsvWriter writer(stream, ';');
+ * for (...)
+ * {
+ *     writer.Field(name);
+ *     writer.Field(value);
+ *     writer.EndRow();
+ * }
+ * if (!writer.Flush())
+ *     ...
+ * @endcode
+ */
+class ARBCOMMON_API CsvWriter
+{
+	DECLARE_NO_COPY_IMPLEMENTED(CsvWriter)
+public:
+	/**
+	 * Write to a stream. Output is buffered until Flush (or destruction).
+	 * @param outStream Output, must outlive the writer.
+	 * @param inSep Separator character.
+	 * @param bAlwaysQuote Always quote fields (default only when needed).
+	 */
+	explicit CsvWriter(std::ostream& outStream, char inSep = ',', bool bAlwaysQuote = false);
+	/**
+	 * Append to a string.
+	 * @param outBuffer Output, must outlive the writer.
+	 * @param inSep Separator character.
+	 * @param bAlwaysQuote Always quote fields (default only when needed).
+	 */
+	explicit CsvWriter(std::string& outBuffer, char inSep = ',', bool bAlwaysQuote = false);
+	/// Flushes the output.
+	~CsvWriter();
+
+	/**
+	 * Add a field to the current row.
+	 * @param inField UTF-8 text.
+	 */
+	void Field(std::string_view inField);
+	/**
+	 * Add a field to the current row.
+	 * @param inField Text, written as UTF-8.
+	 */
+	void Field(wxString const& inField);
+	/**
+	 * End the current row.
+	 */
+	void EndRow();
+
+	/**
+	 * Write a complete row.
+	 * @param inFields Fields to write.
+	 */
+	void WriteRow(std::vector<std::string> const& inFields);
+	void WriteRow(std::vector<std::string_view> const& inFields);
+	void WriteRow(std::vector<wxString> const& inFields);
+
+	/**
+	 * Write buffered output to the stream.
+	 * @return Whether the stream is still good.
+	 */
+	bool Flush();
+
+private:
+	void Separator();
+
+	std::ostream* m_stream;
+	std::string m_buffer;
+	std::string& m_out;
+	char m_sep;
+	bool m_bAlwaysQuote;
+	bool m_bRowStarted;
+	bool m_bEmptyRow; ///< Row so far is one empty, unquoted field
+	bool m_special[256];
+};
+
+} // namespace ARBCommon
+} // namespace dconSoft
@@ -0,0 +1,102 @@
+#pragma once
+
+/*
+ * Copyright (c) David Connet. All Rights Reserved.
+ *
+ * License: See License.txt
+ */
+
+/**
+ * @file
+ * @brief Simple bounded worker pool for independent work items.
+ * @author David Connet
+ *
+ * Revision History
+ * 2026-10-19 Created
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+namespace dconSoft
+{
+namespace ARBCommon
+{
+
+/**
+ * Number of threads to use when the caller doesn't care.
+ */
+inline size_t GetDefaultThreadCount()
+{
+	size_t n = std::thread::hardware_concurrency();
+	return 0 < n ? n : 1;
+}
+
+
+/**
+ * Run 'func(index)' for every index in [0, count) on up to nThreads threads.
+ * Items are handed out one at a time, so slow items don't stall a thread's
+ * pre-assigned range. The calling thread participates in the work.
+ * If any call throws, the first exception is rethrown after all threads have
+ * finished (remaining items are skipped).
+ * @param count Number of work items.
+ * @param nThreads Maximum number of threads (0: number of cores).
+ * @param func Callable taking a size_t index.
+ */
+template <typename FUNC> void ParallelFor(size_t count, size_t nThreads, FUNC const& func)
+{
+	if (0 == count)
+		return;
+	if (0 == nThreads)
+		nThreads = GetDefaultThreadCount();
+	nThreads = std::min(nThreads, count);
+
+	std::atomic<size_t> next(0);
+	std::exception_ptr error;
+	std::mutex errorLock;
+	auto worker = [&]() {
+		for (size_t idx = next++; idx < count; idx = next++)
+		{
+			try
+			{
+				func(idx);
+			}
+			catch (...)
+			{
+				std::lock_guard<std::mutex> lock(errorLock);
+				if (!error)
+					error = std::current_exception();
+				next = count;
+			}
+		}
+	};
+
+	std::vector<std::thread> threads;
+	threads.reserve(nThreads - 1);
+	for (size_t i = 1; i < nThreads; ++i)
+	{
+		// If a thread can't be started, the threads we have (including this
+		// one) do the remaining work. Never leave 'threads' unjoined.
+		try
+		{
+			threads.emplace_back(worker);
+		}
+		catch (...)
+		{
+			break;
+		}
+	}
+	worker();
+	for (auto& thread : threads)
+		thread.join();
+	if (error)
+		std::rethrow_exception(error);
+}
+
+} // namespace ARBCommon
+} // namespace dconSoft
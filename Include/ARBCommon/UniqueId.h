@@ -19,40 +19,67 @@
  * hhhhhhhh-hhhh-hhhh-hhhh-hhhhhhhhhhhh
  *
  * Revision History
+ * 2026-10-19 Add allocation-free Parse/FormatTo and binary read/write.
+ * 2026-10-19 Store the id inline, add std::hash support.
+ * 2026-10-19 Add CreateMany.
  * 2022-10-05 Created
  */
 
 #include "LibwxARBCommon.h"
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <string_view>
+#include <vector>
 
 
 namespace dconSoft
 {
 namespace ARBCommon
 {
-class CUniqueIdImpl;
-
 class ARBCOMMON_API CUniqueId
 {
 public:
-	CUniqueId();
+	CUniqueId()
+		: m_bytes()
+	{
+	}
 	explicit CUniqueId(wxString const& str);
-	CUniqueId(CUniqueId const& rhs);
-	CUniqueId(CUniqueId&& rhs);
-	~CUniqueId();
+	CUniqueId(CUniqueId const& rhs) = default;
+	CUniqueId(CUniqueId&& rhs) = default;
+	~CUniqueId() = default;
 
-	void clear();
+	void clear()
+	{
+		m_bytes.fill(0);
+	}
 	bool Create();
-	bool IsNull() const;
+	/**
+	 * Create a batch of new ids (for instance, when importing records).
+	 * Any id that could not be created is null.
+	 */
+	static std::vector<CUniqueId> CreateMany(size_t inCount);
+	bool IsNull() const
+	{
+		return m_bytes == Bytes();
+	}
 
-	CUniqueId& operator=(CUniqueId const& rhs);
-	CUniqueId& operator=(CUniqueId&& rhs);
+	CUniqueId& operator=(CUniqueId const& rhs) = default;
+	CUniqueId& operator=(CUniqueId&& rhs) = default;
 
-	bool operator==(CUniqueId const& rhs) const;
+	bool operator==(CUniqueId const& rhs) const
+	{
+		return m_bytes == rhs.m_bytes;
+	}
 	bool operator!=(CUniqueId const& rhs) const
 	{
 		return !operator==(rhs);
 	}
-	bool operator<(CUniqueId const& rhs) const;
+	bool operator<(CUniqueId const& rhs) const
+	{
+		return m_bytes < rhs.m_bytes;
+	}
 	bool operator>(CUniqueId const& rhs) const
 	{
 		return rhs.operator<(*this);
@@ -66,12 +93,79 @@ public:
 		return !operator<(rhs);
 	}
 
+	/// Hash value (see std::hash<CUniqueId> below).
+	size_t GetHash() const
+	{
+		// Created ids are random, but parsed ones may differ in just a few
+		// bytes, so mix both halves.
+		uint64_t lo, hi;
+		memcpy(&lo, m_bytes.data(), sizeof(lo));
+		memcpy(&hi, m_bytes.data() + sizeof(lo), sizeof(hi));
+		uint64_t hash = lo ^ (hi * 0x9E3779B97F4A7C15ULL);
+		return static_cast<size_t>(hash ^ (hash >> 32));
+	}
+
 	wxString ToString() const; // Always lower-case
 	bool ParseString(wxString const& str);
 
+	/// Characters written by FormatTo.
+	static constexpr size_t StringLength = 36;
+
+	/**
+	 * Format the id (as ToString) without allocating.
+	 * @param outBuffer At least StringLength characters (not terminated).
+	 * @return Number of characters written (StringLength).
+	 */
+	size_t FormatTo(char* outBuffer) const;
+	size_t FormatTo(wchar_t* outBuffer) const;
+
+	/**
+	 * Parse any of the supported input formats without allocating.
+	 * On failure, the id is cleared (as ParseString).
+	 * @return Whether the id is valid (not null).
+	 */
+	bool Parse(std::string_view str);
+	bool Parse(std::wstring_view str);
+
+	/// Size of the binary form.
+	static constexpr size_t BinarySize = 16;
+
+	/**
+	 * Write the id in binary (same byte order as the string form).
+	 * @param outBuffer At least BinarySize bytes.
+	 */
+	void WriteBinary(unsigned char* outBuffer) const
+	{
+		memcpy(outBuffer, m_bytes.data(), BinarySize);
+	}
+
+	/**
+	 * Read an id written by WriteBinary.
+	 * @param inBuffer At least BinarySize bytes.
+	 * @return Whether the id is valid (not null).
+	 */
+	bool ReadBinary(unsigned char const* inBuffer)
+	{
+		memcpy(m_bytes.data(), inBuffer, BinarySize);
+		return !IsNull();
+	}
+
 private:
-	CUniqueIdImpl* m_impl;
+	typedef std::array<uint8_t, 16> Bytes;
+	Bytes m_bytes; ///< Same byte order as the string form
 };
 
 } // namespace ARBCommon
 } // namespace dconSoft
+
+
+namespace std
+{
+template <> struct hash<dconSoft::ARBCommon::CUniqueId>
+{
+	size_t operator()(dconSoft::ARBCommon::CUniqueId const& id) const
+	{
+		return id.GetHash();
+	}
+};
+} // namespace std
@@ -15,6 +15,7 @@
  * before include wx headers causes issues in msvc)
  *
  * Revision History
+ * 2026-10-19 Added ARB_HAS_LOCALTIME_R.
  * 2018-10-30 Removed unnecessary macros as we require C++11 mode now.
  * 2015-04-04 Add support for C99 printf formats. (Breaking change)
  * 2014-05-16 Moved HAS macros here.
@@ -53,6 +54,12 @@
 #define ARB_HAS_SECURE_LOCALTIME
 #endif
 
+// ARB_HAS_LOCALTIME_R
+//  localtime_r(time_t const*, struct tm*) (POSIX)
+#if !defined(_MSC_VER)
+#define ARB_HAS_LOCALTIME_R
+#endif
+
 // ARB_HAS_SECURE_MBS_WCS
 //  _wcstombs_s(size_t*, char*, size_t, const wchar_t*, size_t)
 #if _MSC_VER >= 1400
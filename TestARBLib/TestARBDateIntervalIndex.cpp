@@ -0,0 +1,170 @@
+/*
+ * Copyright (c) David Connet. All Rights Reserved.
+ *
+ * License: See License.txt
+ */
+
+/**
+ * @file
+ * @brief Test date range index
+ * @author David Connet
+ *
+ * Revision History
+ * 2026-10-19 Created
+ */
+
+#include "stdafx.h"
+#include "TestARBLib.h"
+
+#include "ARBCommon/ARBDateIntervalIndex.h"
+#include <random>
+
+#ifdef __WXMSW__
+#include <wx/msw/msvcrt.h>
+#endif
+
+
+namespace dconSoft
+{
+using namespace ARBCommon;
+
+namespace
+{
+typedef ARBDateIntervalIndex<int> DateIndex;
+
+bool Overlaps(DateIndex::Interval const& inRange, ARBDate inFrom, ARBDate inTo)
+{
+	if (inFrom.IsValid() && inTo.IsValid() && inFrom > inTo)
+		std::swap(inFrom, inTo);
+	ARBDate from(inRange.from);
+	ARBDate to(inRange.to);
+	if (from.IsValid() && to.IsValid() && from > to)
+		std::swap(from, to);
+	return (!from.IsValid() || !inTo.IsValid() || from <= inTo) && (!to.IsValid() || !inFrom.IsValid() || inFrom <= to);
+}
+
+std::vector<int> Sorted(std::vector<int> values)
+{
+	std::sort(values.begin(), values.end());
+	return values;
+}
+
+std::vector<int> Brute(std::vector<DateIndex::Interval> const& inRanges, ARBDate const& inFrom, ARBDate const& inTo)
+{
+	std::vector<int> values;
+	for (auto const& range : inRanges)
+	{
+		if (Overlaps(range, inFrom, inTo))
+			values.push_back(range.value);
+	}
+	std::sort(values.begin(), values.end());
+	return values;
+}
+} // namespace
+
+
+TEST_CASE("DateIntervalIndex")
+{
+	SECTION("Simple")
+	{
+		DateIndex index;
+		REQUIRE(index.empty());
+		index.Build({
+			{ARBDate(2020, 1, 1), ARBDate(2020, 1, 31), 1},
+			{ARBDate(2020, 1, 15), ARBDate(2020, 2, 15), 2},
+			{ARBDate(2020, 3, 1), ARBDate(2020, 2, 1), 3}, // Reversed
+			{ARBDate(2020, 6, 1), ARBDate(), 4},            // Open end
+			{ARBDate(), ARBDate(2019, 12, 31), 5},          // Open start
+		});
+		REQUIRE(index.size() == 5);
+
+		REQUIRE(Sorted(index.FindContaining(ARBDate(2020, 1, 1))) == std::vector<int>{1});
+		REQUIRE(Sorted(index.FindContaining(ARBDate(2020, 1, 20))) == std::vector<int>{1, 2});
+		REQUIRE(Sorted(index.FindContaining(ARBDate(2020, 2, 1))) == std::vector<int>{2, 3});
+		REQUIRE(Sorted(index.FindContaining(ARBDate(2020, 5, 31))).empty());
+		REQUIRE(Sorted(index.FindContaining(ARBDate(2099, 1, 1))) == std::vector<int>{4});
+		REQUIRE(Sorted(index.FindContaining(ARBDate(1900, 1, 1))) == std::vector<int>{5});
+		REQUIRE(index.FindContaining(ARBDate()).empty());
+
+		REQUIRE(Sorted(index.FindOverlapping(ARBDate(2020, 2, 16), ARBDate(2020, 6, 1))) == std::vector<int>{3, 4});
+		REQUIRE(Sorted(index.FindOverlapping(ARBDate(2020, 6, 1), ARBDate(2020, 2, 16))) == std::vector<int>{3, 4});
+		REQUIRE(Sorted(index.FindOverlapping(ARBDate(), ARBDate(2020, 1, 1))) == std::vector<int>{1, 5});
+		REQUIRE(Sorted(index.FindOverlapping(ARBDate(), ARBDate())) == std::vector<int>{1, 2, 3, 4, 5});
+
+		index.Insert(ARBDate(2020, 5, 31), ARBDate(2020, 5, 31), 6);
+		REQUIRE(index.size() == 6);
+		REQUIRE(Sorted(index.FindContaining(ARBDate(2020, 5, 31))) == std::vector<int>{6});
+
+		REQUIRE(index.Remove(ARBDate(2020, 1, 15), ARBDate(2020, 2, 15), 2));
+		REQUIRE(!index.Remove(ARBDate(2020, 1, 15), ARBDate(2020, 2, 15), 2));
+		REQUIRE(!index.Remove(ARBDate(2020, 1, 1), ARBDate(2020, 1, 31), 2));
+		REQUIRE(index.Remove(ARBDate(2020, 5, 31), ARBDate(2020, 5, 31), 6));
+		REQUIRE(index.size() == 4);
+		REQUIRE(Sorted(index.FindContaining(ARBDate(2020, 1, 20))) == std::vector<int>{1});
+		REQUIRE(index.FindContaining(ARBDate(2020, 5, 31)).empty());
+
+		index.clear();
+		REQUIRE(index.empty());
+		REQUIRE(index.FindOverlapping(ARBDate(), ARBDate()).empty());
+	}
+
+
+	SECTION("Random")
+	{
+		// Compare against a linear scan while inserting and removing enough
+		// to force merges and compaction.
+		std::mt19937 gen(42);
+		ARBDate const base(2000, 1, 1);
+		std::uniform_int_distribution<int> day(0, 3650);
+		std::uniform_int_distribution<int> length(0, 60);
+		std::uniform_int_distribution<int> percent(0, 99);
+		auto randomRange = [&](int value) {
+			ARBDate from = base + day(gen);
+			ARBDate to = from + length(gen);
+			int open = percent(gen);
+			if (open < 2)
+				from = ARBDate();
+			else if (open < 4)
+				to = ARBDate();
+			else if (open < 10)
+				std::swap(from, to);
+			return DateIndex::Interval{from, to, value};
+		};
+
+		std::vector<DateIndex::Interval> ranges;
+		for (int i = 0; i < 5000; ++i)
+			ranges.push_back(randomRange(i));
+		DateIndex index;
+		index.Build(ranges);
+
+		int next = static_cast<int>(ranges.size());
+		for (int pass = 0; pass < 50; ++pass)
+		{
+			for (int i = 0; i < 100; ++i)
+			{
+				if (percent(gen) < 50 && !ranges.empty())
+				{
+					size_t n = static_cast<size_t>(gen() % ranges.size());
+					REQUIRE(index.Remove(ranges[n].from, ranges[n].to, ranges[n].value));
+					ranges[n] = ranges.back();
+					ranges.pop_back();
+				}
+				else
+				{
+					ranges.push_back(randomRange(next++));
+					index.Insert(ranges.back().from, ranges.back().to, ranges.back().value);
+				}
+			}
+			REQUIRE(index.size() == ranges.size());
+			for (int i = 0; i < 10; ++i)
+			{
+				ARBDate date = base + day(gen);
+				REQUIRE(Sorted(index.FindContaining(date)) == Brute(ranges, date, date));
+				ARBDate to = date + length(gen);
+				REQUIRE(Sorted(index.FindOverlapping(date, to)) == Brute(ranges, date, to));
+			}
+		}
+	}
+}
+
+} // namespace dconSoft
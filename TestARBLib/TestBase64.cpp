@@ -0,0 +1,232 @@
+/*
+ * Copyright (c) David Connet. All Rights Reserved.
+ *
+ * License: See License.txt
+ */
+
+/**
+ * @file
+ * @brief Test Base64 functions
+ * @author David Connet
+ *
+ * Revision History
+ * 2026-10-19 Added streaming tests.
+ * 2026-10-19 Created
+ */
+
+#include "stdafx.h"
+#include "TestARBLib.h"
+
+#include "ARBCommon/ARBBase64.h"
+#include <random>
+#include <sstream>
+
+#ifdef __WXMSW__
+#include <wx/msw/msvcrt.h>
+#endif
+
+
+namespace dconSoft
+{
+using namespace ARBCommon;
+
+
+TEST_CASE("Base64")
+{
+	static const std::string RawString("This is a test of a string");
+	static const std::string EncodedString("VGhpcyBpcyBhIHRlc3Qgb2YgYSBzdHJpbmc=");
+
+	static const ARBBase64::ARBBase64Kernel Kernels[] = {
+		ARBBase64::ARBBase64Kernel::Scalar,
+		ARBBase64::ARBBase64Kernel::SSE41,
+		ARBBase64::ARBBase64Kernel::AVX2,
+	};
+
+
+	SECTION("Encode")
+	{
+		std::string str;
+		REQUIRE(ARBBase64::Encode(std::vector<unsigned char>(RawString.begin(), RawString.end()), str));
+		REQUIRE(str == EncodedString);
+		REQUIRE(!ARBBase64::Encode(std::vector<unsigned char>(), str));
+		REQUIRE(str.empty());
+	}
+
+
+	SECTION("Decode")
+	{
+		std::vector<unsigned char> data;
+		REQUIRE(ARBBase64::Decode(EncodedString, data));
+		REQUIRE(std::string(data.begin(), data.end()) == RawString);
+		REQUIRE(!ARBBase64::Decode(std::string(), data));
+	}
+
+
+	SECTION("DecodeRules")
+	{
+		std::vector<unsigned char> data;
+		// Line breaks are skipped.
+		REQUIRE(ARBBase64::Decode("VGhp\r\ncyBp\ncw==", data));
+		REQUIRE(std::string(data.begin(), data.end()) == "This is");
+		// Anything after padding is ignored.
+		REQUIRE(ARBBase64::Decode("VGhp=!!!", data));
+		REQUIRE(std::string(data.begin(), data.end()) == "Thi");
+		// Other characters are errors.
+		REQUIRE(!ARBBase64::Decode("VGhp cyBp", data));
+		REQUIRE(data.empty());
+		REQUIRE(!ARBBase64::Decode("VGhp\x80", data));
+	}
+
+
+	SECTION("LineBreaks")
+	{
+		// 57 bytes make a full 76 character line.
+		std::vector<unsigned char> raw(57 * 2 + 1, 'a');
+		std::string str;
+		REQUIRE(ARBBase64::Encode(raw, str));
+		REQUIRE(str.length() == 76 * 2 + 2 + 4);
+		REQUIRE(str[76] == '\n');
+		REQUIRE(str[76 * 2 + 1] == '\n');
+		std::vector<unsigned char> data;
+		REQUIRE(ARBBase64::Decode(str, data));
+		REQUIRE(data == raw);
+	}
+
+
+	SECTION("Kernels")
+	{
+		// All kernels must match the scalar code exactly.
+		std::mt19937 rng(42);
+		for (size_t len = 1; len < 600; ++len)
+		{
+			std::vector<unsigned char> raw(len);
+			for (auto& c : raw)
+				c = static_cast<unsigned char>(rng());
+			std::string expected;
+			REQUIRE(ARBBase64::Encode(raw, expected, ARBBase64::ARBBase64Kernel::Scalar));
+			for (auto kernel : Kernels)
+			{
+				if (!ARBBase64::IsKernelSupported(kernel))
+					continue;
+				std::string str;
+				REQUIRE(ARBBase64::Encode(raw, str, kernel));
+				REQUIRE(str == expected);
+				std::vector<unsigned char> data;
+				REQUIRE(ARBBase64::Decode(str, data, kernel));
+				REQUIRE(data == raw);
+			}
+		}
+	}
+
+
+	SECTION("KernelErrors")
+	{
+		// Mostly valid data with the occasional line break, padding or error.
+		constexpr char chars[]
+			= "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/"
+			  "\r\n= !\x80\xff";
+		std::mt19937 rng(42);
+		for (int i = 0; i < 5000; ++i)
+		{
+			std::string str(rng() % 150 + 1, 'A');
+			for (auto& c : str)
+				c = chars[(rng() % 100 < 97) ? rng() % 64 : rng() % (sizeof(chars) - 1)];
+			std::vector<unsigned char> expected;
+			bool bExpected = ARBBase64::Decode(str, expected, ARBBase64::ARBBase64Kernel::Scalar);
+			for (auto kernel : Kernels)
+			{
+				if (!ARBBase64::IsKernelSupported(kernel))
+					continue;
+				std::vector<unsigned char> data;
+				REQUIRE(ARBBase64::Decode(str, data, kernel) == bExpected);
+				REQUIRE(data == expected);
+			}
+		}
+	}
+
+
+	SECTION("StreamEncode")
+	{
+		std::mt19937 rng(42);
+		std::vector<unsigned char> raw(100000);
+		for (auto& c : raw)
+			c = static_cast<unsigned char>(rng());
+		std::string expected;
+		REQUIRE(ARBBase64::Encode(raw, expected));
+
+		std::ostringstream output;
+		ARBBase64::CEncoder encoder(output);
+		for (size_t pos = 0; pos < raw.size();)
+		{
+			size_t len = std::min(raw.size() - pos, static_cast<size_t>(rng() % 200));
+			REQUIRE(encoder.Write(raw.data() + pos, len));
+			pos += len;
+		}
+		REQUIRE(encoder.Finish());
+		REQUIRE(output.str() == expected);
+
+		std::ostringstream output2;
+		ARBBase64::CEncoder encoder2(output2);
+		REQUIRE(encoder2.Write(raw.data(), raw.size()));
+		REQUIRE(encoder2.Finish());
+		REQUIRE(output2.str() == expected);
+
+		ARBBase64::CEncoder empty([](void const*, size_t) { return true; });
+		REQUIRE(!empty.Finish());
+	}
+
+
+	SECTION("StreamDecode")
+	{
+		std::mt19937 rng(42);
+		std::vector<unsigned char> raw(100000);
+		for (auto& c : raw)
+			c = static_cast<unsigned char>(rng());
+		std::string str;
+		REQUIRE(ARBBase64::Encode(raw, str));
+		str += "\r\n";
+
+		std::vector<unsigned char> data;
+		ARBBase64::CDecoder decoder([&data](void const* p, size_t len) {
+			data.insert(data.end(), static_cast<unsigned char const*>(p), static_cast<unsigned char const*>(p) + len);
+			return true;
+		});
+		for (size_t pos = 0; pos < str.length();)
+		{
+			size_t len = std::min(str.length() - pos, static_cast<size_t>(rng() % 200));
+			REQUIRE(decoder.Write(str.data() + pos, len));
+			pos += len;
+		}
+		REQUIRE(decoder.Finish());
+		REQUIRE(data == raw);
+
+		std::ostringstream output;
+		ARBBase64::CDecoder decoder2(output);
+		REQUIRE(decoder2.Write(str.data(), str.length()));
+		REQUIRE(decoder2.Finish());
+		REQUIRE(output.str() == std::string(raw.begin(), raw.end()));
+	}
+
+
+	SECTION("StreamDecodeErrors")
+	{
+		std::ostringstream output;
+		ARBBase64::CDecoder decoder(output);
+		REQUIRE(decoder.Write("VGhp", 4));
+		REQUIRE(decoder.Write("cy", 2));
+		REQUIRE(decoder.Write("Bp=!", 4));
+		REQUIRE(decoder.Write("!!", 2));
+		REQUIRE(decoder.Finish());
+		REQUIRE(output.str() == "This i");
+
+		ARBBase64::CDecoder bad([](void const*, size_t) { return true; });
+		REQUIRE(bad.Write("VGhp", 4));
+		REQUIRE(!bad.Write("c!", 2));
+		REQUIRE(!bad.Finish());
+
+		ARBBase64::CDecoder stop([](void const*, size_t) { return false; });
+		REQUIRE(!stop.Write("VGhp", 4));
+	}
+}
+
+} // namespace dconSoft
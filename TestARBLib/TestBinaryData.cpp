@@ -10,6 +10,10 @@
  * @author David Connet
  *
  * Revision History
+ * 2026-10-19 Added CDecodeContext corruption tests.
+ * 2026-10-19 Added size hint, DecodeInto and CDecodeContext tests.
+ * 2026-10-19 Added EncodeFile tests.
+ * 2026-10-19 Added large data, string_view and error tests.
  * 2017-11-09 Convert from UnitTest++ to Catch
  * 2009-09-13 Add support for wxWidgets 2.9, deprecate tstring.
  * 2008-01-13 Created
@@ -18,7 +22,11 @@
 #include "stdafx.h"
 #include "TestARBLib.h"
 
+#include "ARBCommon/ARBBase64.h"
 #include "ARBCommon/BinaryData.h"
+#include <wx/ffile.h>
+#include <wx/filename.h>
+#include <random>
 
 #ifdef __WXMSW__
 #include <wx/msw/msvcrt.h>
@@ -79,7 +87,32 @@ TEST_CASE("BinaryData")
 	}
 
 
-	// TODO: Test Encode(FILE*, wxString& outdata)
+	SECTION("EncodeFile")
+	{
+		// Several deflate blocks, with a partial one at the end.
+		std::mt19937 rng(42);
+		std::vector<unsigned char> raw(5 * 1024 * 1024 + 1234);
+		for (auto& c : raw)
+			c = static_cast<unsigned char>('a' + rng() % 8);
+		wxString filename = wxFileName::CreateTempFileName(L"arb");
+		{
+			wxFFile file(filename, L"wb");
+			REQUIRE(file.IsOpened());
+			REQUIRE(file.Write(raw.data(), raw.size()) == raw.size());
+		}
+		for (size_t nThreads : {1, 4})
+		{
+			for (int level : {BinaryData::DefaultCompression, 1, 9})
+			{
+				std::string str;
+				REQUIRE(BinaryData::EncodeFile(filename, str, level, nThreads));
+				std::vector<unsigned char> data;
+				REQUIRE(BinaryData::Decode(str, data));
+				REQUIRE(data == raw);
+			}
+		}
+		wxRemoveFile(filename);
+	}
 
 
 	SECTION("StringDecode")
@@ -106,6 +139,161 @@ TEST_CASE("BinaryData")
 		REQUIRE(BinaryData::DecodeString(str, str2));
 		REQUIRE(RawString == str2);
 	}
+
+
+	SECTION("StringView")
+	{
+		std::string data("xx" + RawString + "xx");
+		std::string str;
+		REQUIRE(BinaryData::EncodeString(std::string_view(data).substr(2, RawString.length()), str));
+		REQUIRE(EncodedString == str);
+		// Input and output may be the same object.
+		REQUIRE(BinaryData::DecodeString(str, str));
+		REQUIRE(RawString == str);
+		REQUIRE(BinaryData::EncodeString(str, str));
+		REQUIRE(EncodedString == str);
+	}
+
+
+	SECTION("Large")
+	{
+		// Compressible, but not trivially.
+		std::mt19937 rng(42);
+		std::vector<unsigned char> raw(3 * 1024 * 1024);
+		for (auto& c : raw)
+			c = static_cast<unsigned char>('a' + rng() % 8);
+		std::string str;
+		REQUIRE(BinaryData::Encode(raw, str));
+		std::vector<unsigned char> data;
+		REQUIRE(BinaryData::Decode(str, data));
+		REQUIRE(data == raw);
+	}
+
+
+	SECTION("SizeHint")
+	{
+		std::vector<unsigned char> data;
+		REQUIRE(BinaryData::Decode(EncodedData, data, RawDataSize));
+		REQUIRE(data == RawData);
+		// Hint too small or too large.
+		REQUIRE(BinaryData::Decode(EncodedData, data, 3));
+		REQUIRE(data == RawData);
+		REQUIRE(BinaryData::Decode(EncodedData, data, 10 * RawDataSize));
+		REQUIRE(data == RawData);
+	}
+
+
+	SECTION("DecodeInto")
+	{
+		std::vector<unsigned char> buffer(RawDataSize + 10, 0xFF);
+		size_t size = 0;
+		REQUIRE(BinaryData::DecodeInto(EncodedData, buffer.data(), RawDataSize, size));
+		REQUIRE(size == RawDataSize);
+		REQUIRE(std::equal(RawData.begin(), RawData.end(), buffer.begin()));
+		REQUIRE(buffer[RawDataSize] == 0xFF);
+		REQUIRE(BinaryData::DecodeInto(EncodedData, buffer.data(), buffer.size(), size));
+		REQUIRE(size == RawDataSize);
+		REQUIRE(std::equal(RawData.begin(), RawData.end(), buffer.begin()));
+		// Too small.
+		REQUIRE(!BinaryData::DecodeInto(EncodedData, buffer.data(), RawDataSize - 1, size));
+		REQUIRE(!BinaryData::DecodeInto(EncodedData, nullptr, 0, size));
+	}
+
+
+	SECTION("DecodeContext")
+	{
+		std::mt19937 rng(42);
+		BinaryData::CDecodeContext context;
+		std::vector<unsigned char> buffer;
+		for (int i = 0; i < 50; ++i)
+		{
+			std::vector<unsigned char> raw(rng() % 5000 + 1);
+			for (auto& c : raw)
+				c = static_cast<unsigned char>('a' + rng() % 8);
+			std::string str;
+			REQUIRE(BinaryData::Encode(raw, str));
+
+			std::vector<unsigned char> data;
+			REQUIRE(context.Decode(str, data, raw.size()));
+			REQUIRE(data == raw);
+			REQUIRE(context.Decode(str, data));
+			REQUIRE(data == raw);
+
+			buffer.resize(raw.size());
+			size_t size = 0;
+			REQUIRE(context.DecodeInto(str, buffer.data(), buffer.size(), size));
+			REQUIRE(size == raw.size());
+			REQUIRE(buffer == raw);
+			REQUIRE(!context.DecodeInto(str, buffer.data(), buffer.size() - 1, size));
+		}
+		std::vector<unsigned char> data;
+		REQUIRE(!context.Decode(std::string_view(), data));
+		REQUIRE(!context.Decode(EncodedData.substr(0, EncodedData.length() - 2) + "!", data));
+		REQUIRE(data.empty());
+	}
+
+
+	SECTION("DecodeContextCorrupt")
+	{
+		// The context drives zlib itself: it must agree with the free
+		// functions on damaged data, and recover for the next blob.
+		std::mt19937 rng(7);
+		BinaryData::CDecodeContext context;
+		std::vector<unsigned char> raw(3000);
+		for (auto& c : raw)
+			c = static_cast<unsigned char>('a' + rng() % 8);
+		std::string str;
+		REQUIRE(BinaryData::Encode(raw, str));
+		std::vector<unsigned char> compressed;
+		REQUIRE(ARBBase64::Decode(str, compressed));
+		for (int i = 0; i < 200; ++i)
+		{
+			std::vector<unsigned char> bad(compressed);
+			if (0 == i % 4)
+				bad.resize(rng() % bad.size());
+			else
+				bad[rng() % bad.size()] ^= static_cast<unsigned char>(1 + rng() % 255);
+			std::string badStr;
+			if (!ARBBase64::Encode(bad, badStr))
+				continue;
+			std::vector<unsigned char> expected, data;
+			bool bOk = BinaryData::Decode(badStr, expected);
+			REQUIRE(context.Decode(badStr, data) == bOk);
+			REQUIRE(data == expected);
+			std::vector<unsigned char> buffer(raw.size());
+			size_t expectedSize = 0, size = 0;
+			bOk = BinaryData::DecodeInto(badStr, buffer.data(), buffer.size(), expectedSize);
+			REQUIRE(context.DecodeInto(badStr, buffer.data(), buffer.size(), size) == bOk);
+			if (bOk)
+				REQUIRE(size == expectedSize);
+
+			REQUIRE(context.Decode(str, data));
+			REQUIRE(data == raw);
+		}
+	}
+
+
+	SECTION("Errors")
+	{
+		std::vector<unsigned char> data;
+		REQUIRE(!BinaryData::Decode(std::string_view(), data));
+		std::string str;
+		REQUIRE(!BinaryData::Encode(std::vector<unsigned char>(), str));
+		// Invalid text after the compressed data is still an error.
+		REQUIRE(!BinaryData::Decode(EncodedString.substr(0, EncodedString.length() - 2) + "!", data));
+		REQUIRE(data.empty());
+		// Truncated zlib data.
+		std::string str2;
+		std::vector<unsigned char> raw(RawData);
+		REQUIRE(BinaryData::Encode(raw, str2));
+		std::vector<unsigned char> compressed;
+		REQUIRE(ARBBase64::Decode(str2, compressed));
+		compressed.resize(compressed.size() / 2);
+		REQUIRE(ARBBase64::Encode(compressed, str2));
+		REQUIRE(!BinaryData::Decode(str2, data));
+		BinaryData::CDecodeContext context;
+		REQUIRE(!context.Decode(str2, data));
+	}
 }
 #endif
 
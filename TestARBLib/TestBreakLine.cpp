@@ -10,6 +10,8 @@
  * @author David Connet
  *
  * Revision History
+ * 2026-10-19 Add string_view BreakLine and ForEachField tests.
+ * 2026-10-19 Add WriteCSVField test.
  * 2017-11-09 Convert from UnitTest++ to Catch
  * 2012-07-25 Add 2 multiline CSV tests.
  * 2010-10-17 Created
@@ -91,6 +93,60 @@ TEST_CASE("BreakLine")
 	}
 
 
+	SECTION("BreakLineView")
+	{
+		std::vector<std::wstring_view> fields;
+		REQUIRE(4u == BreakLine(';', std::wstring_view(record4), fields));
+		REQUIRE(4u == fields.size());
+		REQUIRE(fields[2].empty());
+		REQUIRE(fields[3] == L"fld");
+		REQUIRE(fields[3].data() == record4 + 9);
+		REQUIRE(4u == BreakLine(';', std::wstring_view(record4), fields, true));
+		REQUIRE(3u == fields.size());
+		REQUIRE(7u == BreakLine(';', std::wstring_view(record7), fields));
+		REQUIRE(7u == fields.size());
+		REQUIRE(7u == BreakLine(';', std::wstring_view(record7), fields, true));
+		REQUIRE(6u == fields.size());
+		REQUIRE(0u == BreakLine(';', std::wstring_view(), fields));
+		REQUIRE(fields.empty());
+		REQUIRE(2u == BreakLine(';', std::wstring_view(L";"), fields));
+		REQUIRE(2u == fields.size());
+
+		// Same results as the wxString version.
+		wxString str(record7);
+		std::vector<wxString> fields2;
+		BreakLine(';', str, fields2);
+		BreakLine(';', std::wstring_view(str.wc_str(), str.length()), fields);
+		REQUIRE(fields.size() == fields2.size());
+		for (size_t i = 0; i < fields.size(); ++i)
+			REQUIRE(wxString(fields[i].data(), fields[i].size()) == fields2[i]);
+	}
+
+
+	SECTION("ForEachField")
+	{
+		std::wstring_view third(L"x");
+		int n = 0;
+		size_t count = ForEachField(';', record7, [&third, &n](std::wstring_view field) {
+			if (2 == n++)
+				third = field;
+			return true;
+		});
+		REQUIRE(7u == count);
+		REQUIRE(7 == n);
+		REQUIRE(third.empty());
+
+		// Stop early.
+		std::vector<std::wstring_view> fields;
+		count = ForEachField(';', record7, [&fields](std::wstring_view field) {
+			fields.push_back(field);
+			return fields.size() < 2;
+		});
+		REQUIRE(2u == count);
+		REQUIRE(fields[1] == L"fld");
+	}
+
+
 	SECTION("ReadCSV")
 	{
 		std::vector<wxString> fields;
@@ -178,6 +234,17 @@ TEST_CASE("BreakLine")
 		wxString data = WriteCSV(';', fields);
 		REQUIRE(data == record5);
 	}
+
+
+	SECTION("WriteCSVField")
+	{
+		REQUIRE(WriteCSVField(';', L"a") == L"a");
+		REQUIRE(WriteCSVField(';', L"a", true) == L"\"a\"");
+		REQUIRE(WriteCSVField(';', L"\"a\"\"b\"") == L"\"\"\"a\"\"\"\"b\"\"\"");
+		wxString data(L"x;");
+		WriteCSVField(';', L"a;b", false, data);
+		REQUIRE(data == L"x;\"a;b\"");
+	}
 }
 
 } // namespace dconSoft
@@ -0,0 +1,342 @@
+/*
+ * Copyright (c) David Connet. All Rights Reserved.
+ *
+ * License: See License.txt
+ */
+
+/**
+ * @file
+ * @brief Test CSV reader
+ * @author David Connet
+ *
+ * Revision History
+ * 2026-10-19 Added stream failure test.
+ * 2026-10-19 Added multi-threaded import tests.
+ * 2026-10-19 Added field length tests for the vectorized scan.
+ * 2026-10-19 Created
+ */
+
+#include "stdafx.h"
+#include "TestARBLib.h"
+
+#include "ARBCommon/CsvReader.h"
+#include <wx/ffile.h>
+#include <wx/filename.h>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+
+#ifdef __WXMSW__
+#include <wx/msw/msvcrt.h>
+#endif
+
+
+namespace dconSoft
+{
+using namespace ARBCommon;
+
+namespace
+{
+
+std::vector<std::vector<std::string>> ReadAll(CsvReader& reader)
+{
+	std::vector<std::vector<std::string>> rows;
+	while (reader.ReadRow())
+	{
+		rows.emplace_back();
+		for (auto field : reader.Fields())
+			rows.back().emplace_back(field);
+	}
+	return rows;
+}
+
+
+// About 6MB: several chunks for the parallel reader. Quoted fields with
+// newlines and separators land on chunk boundaries.
+std::string MakeData()
+{
+	std::mt19937 rng(42);
+	std::string data;
+	for (int row = 0; data.size() < 6 * 1024 * 1024; ++row)
+	{
+		data += std::to_string(row);
+		for (int fld = 0; fld < 5; ++fld)
+		{
+			data += ';';
+			switch (rng() % 4)
+			{
+			case 0:
+				data += "\"quoted;\n\"\"text\"\"\r\nmore\"";
+				break;
+			case 1:
+				data += std::string(rng() % 300, 'x');
+				break;
+			case 2:
+				break;
+			default:
+				data += "field";
+				break;
+			}
+		}
+		data += (0 == row % 3) ? "\r\n" : "\n";
+	}
+	return data;
+}
+
+
+// Serves 'rows' copies of "a;b\n", then fails (istream::read sets badbit).
+class FailingBuf : public std::streambuf
+{
+public:
+	explicit FailingBuf(int rows)
+		: m_rows(rows)
+		, m_row("a;b\n")
+	{
+	}
+
+protected:
+	int_type underflow() override
+	{
+		if (0 == m_rows--)
+			throw std::runtime_error("read failed");
+		setg(&m_row[0], &m_row[0], &m_row[0] + m_row.size());
+		return traits_type::to_int_type(m_row[0]);
+	}
+
+private:
+	int m_rows;
+	std::string m_row;
+};
+
+} // namespace
+
+
+TEST_CASE("CsvReader")
+{
+	// Same data as the ReadCSV tests in TestBreakLine.
+	static const std::string Data(
+		"fld;\"line\n;line\";\"\"\"quote\"\" here\";;\n"
+		"2010-10-30;Name;\"Subname\";\"Line 1\r\nLine 2\"\r\n"
+		"field1;\"Line1\nLine2\n\nLine3\";field3");
+	static const std::vector<std::vector<std::string>> Expected = {
+		{"fld", "line\n;line", "\"quote\" here", "", ""},
+		{"2010-10-30", "Name", "Subname", "Line 1\nLine 2"},
+		{"field1", "Line1\nLine2\n\nLine3", "field3"},
+	};
+
+
+	SECTION("Memory")
+	{
+		CsvReader reader(Data, ';');
+		REQUIRE(ReadAll(reader) == Expected);
+		REQUIRE(!reader.IsError());
+		REQUIRE(reader.GetLineNumber() == 5);
+		REQUIRE(!reader.ReadRow());
+	}
+
+
+	SECTION("Stream")
+	{
+		std::istringstream stream(Data);
+		CsvReader reader(stream, ';');
+		REQUIRE(ReadAll(reader) == Expected);
+		REQUIRE(!reader.IsError());
+		REQUIRE(reader.GetResult() == CsvResult::Ok);
+	}
+
+
+	SECTION("StreamFailure")
+	{
+		// Enough rows to need several reads. Rows before the failure are
+		// returned, the partial buffer is not parsed as a last row.
+		FailingBuf buf(50000);
+		std::istream stream(&buf);
+		CsvReader reader(stream, ';');
+		size_t rows = 0;
+		while (reader.ReadRow())
+		{
+			REQUIRE(reader.Fields() == std::vector<std::string_view>{"a", "b"});
+			++rows;
+		}
+		REQUIRE(reader.IsError());
+		REQUIRE(reader.IsReadError());
+		REQUIRE(reader.GetResult() == CsvResult::Error);
+		REQUIRE(rows < 50000);
+		REQUIRE(reader.GetLineNumber() == rows + 1);
+		REQUIRE(!reader.ReadRow());
+	}
+
+
+	SECTION("LargeStream")
+	{
+		// Rows cross the stream's chunk boundaries, one field is larger than
+		// a chunk.
+		std::string big(200000, 'x');
+		std::ostringstream data;
+		data << "\xEF\xBB\xBF";
+		for (int i = 0; i < 20000; ++i)
+			data << i << ",\"a,\"\"b\"\"\r\nc\"," << (i == 10000 ? big : std::string("z")) << "\r\n";
+		std::istringstream stream(data.str());
+		CsvReader reader(stream);
+		int row = 0;
+		while (reader.ReadRow())
+		{
+			REQUIRE(reader.Fields().size() == 3);
+			REQUIRE(reader.Fields()[0] == std::to_string(row));
+			REQUIRE(reader.Fields()[1] == "a,\"b\"\nc");
+			REQUIRE(reader.Fields()[2] == (row == 10000 ? big : std::string("z")));
+			REQUIRE(reader.GetLineNumber() == static_cast<size_t>(2 * row + 1));
+			++row;
+		}
+		REQUIRE(!reader.IsError());
+		REQUIRE(row == 20000);
+	}
+
+
+	SECTION("FieldLengths")
+	{
+		// Separators, quotes and newlines at every position of a 16 byte scan.
+		for (size_t len = 0; len < 40; ++len)
+		{
+			std::string text(len, 'x');
+			std::string data = text + ";\"" + text + "\"\"" + text + "\r\n" + text + ";" + text + "\"\r\n";
+			CsvReader reader(data, ';');
+			REQUIRE(reader.ReadRow());
+			REQUIRE(reader.Fields().size() == 2);
+			REQUIRE(reader.Fields()[0] == text);
+			REQUIRE(reader.Fields()[1] == text + "\"" + text + "\n" + text + ";" + text);
+			REQUIRE(!reader.ReadRow());
+			REQUIRE(!reader.IsError());
+
+			std::string badData = text + "\"" + text;
+			CsvReader bad(badData, ';');
+			REQUIRE(!bad.ReadRow());
+			REQUIRE(bad.IsError());
+		}
+	}
+
+
+	SECTION("EmptyFields")
+	{
+		CsvReader reader(std::string_view("\n,\n\"\"\na,\n,a\r\n\r\na,"));
+		std::vector<std::vector<std::string>> expected = {
+			{},
+			{"", ""},
+			{""},
+			{"a", ""},
+			{"", "a"},
+			{},
+			{"a", ""},
+		};
+		REQUIRE(ReadAll(reader) == expected);
+		REQUIRE(!reader.IsError());
+
+		CsvReader empty(std::string_view(""));
+		REQUIRE(!empty.ReadRow());
+		REQUIRE(!empty.IsError());
+	}
+
+
+	SECTION("Errors")
+	{
+		static char const* const Bad[] = {
+			"f\";",
+			"fld;fld;;fld;f\"f;f6;f7",
+			"\"abc\"d,e",
+			"\"abc",
+			"a,\"abc\"\rb",
+		};
+		for (auto bad : Bad)
+		{
+			CsvReader reader(std::string_view(bad), ';');
+			REQUIRE(!reader.ReadRow());
+			REQUIRE(reader.IsError());
+			REQUIRE(!reader.ReadRow());
+		}
+
+		CsvReader reader(std::string_view("a\nb\n\"c\n\nd\"x\n"));
+		REQUIRE(reader.ReadRow());
+		REQUIRE(reader.ReadRow());
+		REQUIRE(!reader.ReadRow());
+		REQUIRE(reader.IsError());
+		REQUIRE(reader.GetLineNumber() == 3);
+	}
+}
+
+
+TEST_CASE("CsvReaderParallel")
+{
+	static const std::string Data(MakeData());
+	CsvReader reader(Data, ';');
+	static const std::vector<std::vector<std::string>> Expected(ReadAll(reader));
+
+
+	SECTION("Rows")
+	{
+		for (size_t nThreads : {1, 3, 8})
+		{
+			std::vector<std::vector<std::string>> rows;
+			REQUIRE(CsvResult::Ok == ReadCsvRows(Data, ';', rows, nThreads));
+			REQUIRE(rows == Expected);
+		}
+		std::vector<std::vector<std::string>> rows;
+		REQUIRE(CsvResult::Ok == ReadCsvRows(std::string_view(), ';', rows));
+		REQUIRE(rows.empty());
+	}
+
+
+	SECTION("Error")
+	{
+		// A stray quote late in the data: same line as a sequential read.
+		std::string data(Data);
+		size_t pos = data.find("field", data.size() - 100000);
+		data.insert(pos + 2, "\"");
+		CsvReader seq(data, ';');
+		while (seq.ReadRow())
+			;
+		REQUIRE(seq.IsError());
+		std::vector<std::vector<std::string>> rows;
+		size_t line = 0;
+		REQUIRE(CsvResult::Error == ReadCsvRows(data, ';', rows, 4, CsvProgress(), &line));
+		REQUIRE(line == seq.GetLineNumber());
+		REQUIRE(rows.empty());
+	}
+
+
+	SECTION("Progress")
+	{
+		std::vector<std::vector<std::string>> rows;
+		size_t last = 0;
+		auto progress = [&last](size_t done, size_t total) {
+			REQUIRE(last <= done);
+			REQUIRE(done <= total);
+			last = done;
+			return true;
+		};
+		REQUIRE(CsvResult::Ok == ReadCsvRows(Data, ';', rows, 4, progress));
+		REQUIRE(last == Data.size());
+
+		auto cancel = [](size_t, size_t) {
+			return false;
+		};
+		REQUIRE(CsvResult::Canceled == ReadCsvRows(Data, ';', rows, 4, cancel));
+		REQUIRE(rows.empty());
+	}
+
+
+	SECTION("File")
+	{
+		wxString filename = wxFileName::CreateTempFileName(L"arb");
+		{
+			wxFFile file(filename, L"wb");
+			REQUIRE(file.IsOpened());
+			REQUIRE(file.Write(Data.data(), Data.size()) == Data.size());
+		}
+		std::vector<std::vector<std::string>> rows;
+		REQUIRE(CsvResult::Ok == ReadCsvFile(filename, ';', rows));
+		REQUIRE(rows == Expected);
+		wxRemoveFile(filename);
+	}
+}
+
+} // namespace dconSoft
@@ -0,0 +1,198 @@
+/*
+ * Copyright (c) David Connet. All Rights Reserved.
+ *
+ * License: See License.txt
+ */
+
+/**
+ * @file
+ * @brief Test columnar CSV import
+ * @author David Connet
+ *
+ * Revision History
+ * 2026-10-19 Added in place column widening test.
+ * 2026-10-19 Added leading sign test.
+ * 2026-10-19 Created
+ */
+
+#include "stdafx.h"
+#include "TestARBLib.h"
+
+#include "ARBCommon/CsvTable.h"
+
+#ifdef __WXMSW__
+#include <wx/msw/msvcrt.h>
+#endif
+
+
+namespace dconSoft
+{
+using namespace ARBCommon;
+
+
+TEST_CASE("CsvTable")
+{
+	SECTION("Types")
+	{
+		static const std::string Data(
+			"Id;Score;Date;Name;Empty\n"
+			"1;95.5;2010-10-30;Dog;\n"
+			"2;88;2010-11-01;\"Other; dog\";\n"
+			"-3;;2011-01-15;Dog;\n"
+			";1e2;;;\n");
+		CsvTable table;
+		REQUIRE(CsvResult::Ok == table.Read(Data, ';', true));
+		REQUIRE(table.GetRowCount() == 4);
+		REQUIRE(table.GetColumnCount() == 5);
+
+		auto const& id = table.GetColumn(0);
+		REQUIRE(id.GetName() == "Id");
+		REQUIRE(id.GetType() == CsvColumnType::Integer);
+		REQUIRE(id.size() == 4);
+		REQUIRE(id.GetInteger(0) == 1);
+		REQUIRE(id.GetInteger(2) == -3);
+		REQUIRE(id.IsEmpty(3));
+		REQUIRE(id.GetDouble(1) == 2.0);
+
+		auto const& score = table.GetColumn(1);
+		REQUIRE(score.GetType() == CsvColumnType::Double);
+		REQUIRE(score.GetDouble(0) == 95.5);
+		REQUIRE(score.GetDouble(1) == 88.0);
+		REQUIRE(score.IsEmpty(2));
+		REQUIRE(score.GetDouble(3) == 100.0);
+
+		auto const& date = table.GetColumn(2);
+		REQUIRE(date.GetType() == CsvColumnType::Date);
+		REQUIRE(date.GetDate(0) == ARBDate(2010, 10, 30));
+		REQUIRE(date.GetDate(2) == ARBDate(2011, 1, 15));
+		REQUIRE(date.IsEmpty(3));
+		REQUIRE(!date.GetDate(3).IsValid());
+
+		auto const& name = table.GetColumn(3);
+		REQUIRE(name.GetType() == CsvColumnType::String);
+		REQUIRE(name.GetString(0) == "Dog");
+		REQUIRE(name.GetString(1) == "Other; dog");
+		REQUIRE(name.GetString(3).empty());
+		REQUIRE(name.IsEmpty(3));
+		// Dictionary encoded: "Dog", "Other; dog" and "".
+		REQUIRE(name.GetDictionarySize() == 3);
+		REQUIRE(name.GetCode(0) == name.GetCode(2));
+		REQUIRE(name.GetDictionaryEntry(name.GetCode(1)) == "Other; dog");
+
+		auto const& empty = table.GetColumn(4);
+		REQUIRE(empty.GetName() == "Empty");
+		for (size_t row = 0; row < table.GetRowCount(); ++row)
+			REQUIRE(empty.IsEmpty(row));
+	}
+
+
+	SECTION("Sign")
+	{
+		// One leading '+' is allowed (as in strtod), a second sign is not.
+		static const std::string Data(
+			"+5;+1.5e+2;+-5;+\n"
+			"-5;-2.5;3;4\n");
+		CsvTable table;
+		REQUIRE(CsvResult::Ok == table.Read(Data, ';', false));
+		REQUIRE(table.GetColumn(0).GetType() == CsvColumnType::Integer);
+		REQUIRE(table.GetColumn(0).GetInteger(0) == 5);
+		REQUIRE(table.GetColumn(0).GetInteger(1) == -5);
+		REQUIRE(table.GetColumn(1).GetType() == CsvColumnType::Double);
+		REQUIRE(table.GetColumn(1).GetDouble(0) == 150.0);
+		REQUIRE(table.GetColumn(1).GetDouble(1) == -2.5);
+		REQUIRE(table.GetColumn(2).GetType() == CsvColumnType::String);
+		REQUIRE(table.GetColumn(2).GetString(0) == "+-5");
+		REQUIRE(table.GetColumn(3).GetType() == CsvColumnType::String);
+		REQUIRE(table.GetColumn(3).GetString(0) == "+");
+	}
+
+
+	SECTION("LateChanges")
+	{
+		// Values after the sampled rows that don't fit the inferred type.
+		std::string data;
+		for (int i = 0; i < 2000; ++i)
+			data += std::to_string(i) + "," + std::to_string(i) + ",10/30/2010\n";
+		data += "1.5,x,x,extra\n";
+		CsvTable table;
+		REQUIRE(CsvResult::Ok == table.Read(data, ',', false, ARBDateFormat::SlashMDY));
+		REQUIRE(table.GetRowCount() == 2001);
+		REQUIRE(table.GetColumnCount() == 4);
+		REQUIRE(table.GetColumn(0).GetType() == CsvColumnType::Double);
+		REQUIRE(table.GetColumn(0).GetDouble(1999) == 1999.0);
+		REQUIRE(table.GetColumn(0).GetDouble(2000) == 1.5);
+		REQUIRE(table.GetColumn(1).GetType() == CsvColumnType::String);
+		REQUIRE(table.GetColumn(1).GetString(1999) == "1999");
+		REQUIRE(table.GetColumn(2).GetType() == CsvColumnType::String);
+		REQUIRE(table.GetColumn(2).GetDictionarySize() == 2);
+		REQUIRE(table.GetColumn(3).GetType() == CsvColumnType::String);
+		REQUIRE(table.GetColumn(3).IsEmpty(0));
+		REQUIRE(table.GetColumn(3).GetString(2000) == "extra");
+		REQUIRE(table.GetColumn(3).GetName().empty());
+	}
+
+
+	SECTION("Widen")
+	{
+		// A column widened twice (integer, double, string), with short rows
+		// and empty cells before and rows after each change.
+		std::string data("A,B\n");
+		for (int i = 0; i < 3000; ++i)
+		{
+			if (1500 == i)
+				data += "2.5,x\n";
+			else if (2000 == i)
+				data += "text,y\n";
+			else if (0 == i % 7)
+				data += "\n";
+			else if (0 == i % 5)
+				data += std::to_string(i) + "\n";
+			else
+				data += std::to_string(i) + "," + std::to_string(i) + "\n";
+		}
+		CsvTable table;
+		REQUIRE(CsvResult::Ok == table.Read(data, ',', true));
+		REQUIRE(table.GetRowCount() == 3000);
+		REQUIRE(table.GetColumnCount() == 2);
+		for (size_t col = 0; col < 2; ++col)
+		{
+			auto const& column = table.GetColumn(col);
+			REQUIRE(column.GetName() == (0 == col ? "A" : "B"));
+			REQUIRE(column.GetType() == CsvColumnType::String);
+			for (int i = 0; i < 3000; ++i)
+			{
+				std::string expected;
+				if (1500 == i)
+					expected = 0 == col ? "2.5" : "x";
+				else if (2000 == i)
+					expected = 0 == col ? "text" : "y";
+				else if (0 != i % 7 && (0 == col || 0 != i % 5))
+					expected = std::to_string(i);
+				REQUIRE(column.IsEmpty(i) == expected.empty());
+				REQUIRE(column.GetString(i) == expected);
+			}
+		}
+
+		// Integer to double keeps the converted values.
+		REQUIRE(CsvResult::Ok == table.Read(data.substr(0, data.find("text")), ',', true));
+		REQUIRE(table.GetRowCount() == 2000);
+		REQUIRE(table.GetColumn(0).GetType() == CsvColumnType::Double);
+		REQUIRE(table.GetColumn(0).GetDouble(1) == 1.0);
+		REQUIRE(table.GetColumn(0).IsEmpty(7));
+		REQUIRE(table.GetColumn(0).GetDouble(1500) == 2.5);
+		REQUIRE(table.GetColumn(0).GetDouble(1999) == 1999.0);
+	}
+
+
+	SECTION("Error")
+	{
+		CsvTable table;
+		size_t line = 0;
+		REQUIRE(CsvResult::Error == table.Read("a,b\n1,2\n3,\"4\n", ',', true, ARBDateFormat::ISO, &line));
+		REQUIRE(line == 3);
+		REQUIRE(table.GetRowCount() == 0);
+		REQUIRE(table.GetColumnCount() == 0);
+	}
+}
+
+} // namespace dconSoft
@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) David Connet. All Rights Reserved.
+ *
+ * License: See License.txt
+ */
+
+/**
+ * @file
+ * @brief Test CSV writer
+ * @author David Connet
+ *
+ * Revision History
+ * 2026-10-19 Added empty field round trip test.
+ * 2026-10-19 Created
+ */
+
+#include "stdafx.h"
+#include "TestARBLib.h"
+
+#include "ARBCommon/BreakLine.h"
+#include "ARBCommon/CsvReader.h"
+#include "ARBCommon/CsvWriter.h"
+#include <sstream>
+
+#ifdef __WXMSW__
+#include <wx/msw/msvcrt.h>
+#endif
+
+
+namespace dconSoft
+{
+using namespace ARBCommon;
+
+
+TEST_CASE("CsvWriter")
+{
+	// Same fields as the WriteCSV test in TestBreakLine.
+	static const std::vector<std::string> Fields = {"fld", "line\n;line", "\"quote\" here", "", ""};
+	static const std::string Record("fld;\"line\n;line\";\"\"\"quote\"\" here\";;\n");
+
+
+	SECTION("String")
+	{
+		std::string out("x");
+		{
+			CsvWriter writer(out, ';');
+			writer.WriteRow(Fields);
+			writer.Field(std::string_view("a"));
+			writer.Field(std::string_view("b\r"));
+			writer.EndRow();
+			writer.EndRow();
+		}
+		REQUIRE(out == "x" + Record + "a;\"b\r\"\n\n");
+	}
+
+
+	SECTION("AlwaysQuote")
+	{
+		std::string out;
+		CsvWriter writer(out, ',', true);
+		writer.WriteRow(std::vector<std::string_view>{"a", "", "b\"c"});
+		REQUIRE(out == "\"a\",\"\",\"b\"\"c\"\n");
+	}
+
+
+	SECTION("WxString")
+	{
+		std::vector<wxString> fields;
+		for (auto const& field : Fields)
+			fields.push_back(wxString::FromUTF8(field.c_str()));
+		std::string out;
+		CsvWriter writer(out, ';');
+		writer.WriteRow(fields);
+		REQUIRE(out == Record);
+		REQUIRE(WriteCSV(L';', fields) + L"\n" == wxString::FromUTF8(out.c_str()));
+	}
+
+
+	SECTION("Stream")
+	{
+		std::ostringstream stream;
+		std::string expected;
+		{
+			CsvWriter writer(stream, ';');
+			for (int i = 0; i < 10000; ++i)
+			{
+				writer.WriteRow(Fields);
+				expected += Record;
+			}
+			// Nothing is written until the buffer fills.
+			REQUIRE(stream.str().size() < expected.size());
+			REQUIRE(writer.Flush());
+			REQUIRE(stream.str() == expected);
+			writer.WriteRow(Fields);
+			expected += Record;
+		}
+		REQUIRE(stream.str() == expected);
+	}
+
+
+	SECTION("RoundTrip")
+	{
+		static const std::vector<std::string> Tricky
+			= {"", "\"", "\"\"", "a\"b\"c\"", ";", "\n", "\r\n", " x ", std::string(1000, '"')};
+		std::string out;
+		{
+			CsvWriter writer(out, ';');
+			for (auto const& field : Tricky)
+				writer.WriteRow(std::vector<std::string>{field, field});
+		}
+		CsvReader reader(out, ';');
+		for (auto const& field : Tricky)
+		{
+			REQUIRE(reader.ReadRow());
+			REQUIRE(reader.Fields().size() == 2);
+			// CRLF inside quotes is read back as LF.
+			std::string expected = field == "\r\n" ? "\n" : field;
+			REQUIRE(reader.Fields()[0] == expected);
+			REQUIRE(reader.Fields()[1] == expected);
+		}
+		REQUIRE(!reader.ReadRow());
+		REQUIRE(!reader.IsError());
+	}
+
+
+	SECTION("EmptyFields")
+	{
+		static const std::vector<std::vector<std::string>> Rows = {{""}, {"", ""}, {}, {""}, {"", "x"}};
+		std::string out;
+		{
+			CsvWriter writer(out, ';');
+			for (auto const& row : Rows)
+				writer.WriteRow(row);
+		}
+		REQUIRE(out == "\"\"\n;\n\n\"\"\n;x\n");
+		CsvReader reader(out, ';');
+		for (auto const& row : Rows)
+		{
+			REQUIRE(reader.ReadRow());
+			REQUIRE(std::vector<std::string>(reader.Fields().begin(), reader.Fields().end()) == row);
+		}
+		REQUIRE(!reader.ReadRow());
+		REQUIRE(!reader.IsError());
+	}
+}
+
+} // namespace dconSoft
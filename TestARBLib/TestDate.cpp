@@ -10,6 +10,11 @@
  * @author David Connet
  *
  * Revision History
+ * 2026-10-19 Test batch conversions at MaxBatchJulian.
+ * 2026-10-19 Added constexpr tests.
+ * 2026-10-19 Added Today tests.
+ * 2026-10-19 Added batch conversion tests.
+ * 2026-10-19 Added Parse, AppendTo and FormatTo tests.
  * 2017-11-09 Convert from UnitTest++ to Catch
  * 2013-10-07 Added leap year tests.
  * 2012-10-26 Changed ARBDate::GetTime to avoid time_t when possible.
@@ -22,6 +27,8 @@
 #include "TestARBLib.h"
 
 #include "ARBCommon/ARBDate.h"
+#include <thread>
+#include <time.h>
 
 #ifdef __WXMSW__
 #include <wx/msw/msvcrt.h>
@@ -55,6 +62,46 @@ TEST_CASE("Date")
 #endif
 
 
+	SECTION("Constexpr")
+	{
+		// Known julian days.
+		static_assert(ARBDate(2000, 1, 1).GetJulianDay() == 2451545);
+		static_assert(ARBDate(1582, 10, 15).GetJulianDay() == 2299161);
+		static_assert(ARBDate::GregorianToSdn(-4714, 11, 25) == 1);
+		static_assert(!ARBDate(-4714, 11, 24).IsValid());
+		// There is no year 0.
+		static_assert(!ARBDate(0, 1, 1).IsValid());
+		static_assert(ARBDate(-1, 12, 31) + 1 == ARBDate(1, 1, 1));
+		// Leap years.
+		static_assert(ARBDate(2000, 2, 29).IsValid());
+		static_assert(ARBDate(2004, 2, 29).isLeap());
+		static_assert(!ARBDate(1900, 2, 29).IsValid());
+		static_assert(!ARBDate(2001, 2, 29).IsValid());
+		static_assert(!ARBDate(2001, 1, 1).isLeap());
+		static_assert(ARBDate(2000, 3, 1) - ARBDate(2000, 2, 28) == 2);
+		static_assert(ARBDate(1900, 3, 1) - ARBDate(1900, 2, 28) == 1);
+		// Month and range checks.
+		static_assert(!ARBDate(2010, 4, 31).IsValid());
+		static_assert(ARBDate(2010, 12, 31).IsValid());
+		static_assert(!ARBDate(2010, 13, 1).IsValid());
+		static_assert(!ARBDate(2010, 0, 1).IsValid());
+		static_assert(!ARBDate(2010, 1, 0).IsValid());
+		static_assert(ARBDate::GregorianToSdn(2010, 2, 31) == ARBDate(2010, 3, 3).GetJulianDay());
+		// Fields.
+		static_assert(ARBDate(1999, 3, 27).GetYear() == 1999);
+		static_assert(ARBDate(1999, 3, 27).GetMonth() == 3);
+		static_assert(ARBDate(1999, 3, 27).GetDay() == 27);
+		static_assert(ARBDate(2004, 12, 31).GetDayOfYear() == 366);
+		static_assert(ARBDate(2009, 12, 31).GetDayOfYear() == 365);
+		static_assert(ARBDate(2009, 4, 12).GetDayOfWeek() == 0);
+		static_assert(ARBDate(2009, 4, 13).GetDayOfWeek(ARBDayOfWeek::Monday) == 0);
+		static_assert(ARBDate(2010, 1, 1) + 365 == ARBDate(2011, 1, 1));
+		static_assert(ARBDate(2010, 1, 5).isBetween(ARBDate(2010, 1, 10), ARBDate(2010, 1, 1)));
+		static_assert(ARBDate(2009, 12, 31) < ARBDate(2010, 1, 1));
+		REQUIRE(ARBDate(2000, 1, 1).GetJulianDay() == 2451545);
+	}
+
+
 	SECTION("Valid")
 	{
 		ARBDate d(1999, 3, 27);
@@ -142,6 +189,41 @@ TEST_CASE("Date")
 	}
 
 
+	SECTION("AppendTo")
+	{
+		wxString str(L"Date: ");
+		ARBDate(1999, 3, 2).AppendTo(str, ARBDateFormat::ISO);
+		REQUIRE(L"Date: 1999-03-02" == str);
+		ARBDate().AppendTo(str, ARBDateFormat::ISO);
+		REQUIRE(L"Date: 1999-03-02" == str);
+		ARBDate(2010, 12, 31).AppendTo(str, ARBDateFormat::SlashDMY);
+		REQUIRE(L"Date: 1999-03-0231/12/2010" == str);
+		REQUIRE(L"0999-01-05" == ARBDate(999, 1, 5).GetString(ARBDateFormat::ISO));
+		REQUIRE(L"1-5-999" == ARBDate(999, 1, 5).GetString(ARBDateFormat::DashMDY));
+		REQUIRE(ARBDate::Today().GetString(ARBDateFormat::ISO) == ARBDate().GetString(ARBDateFormat::ISO, true));
+	}
+
+
+	SECTION("FormatTo")
+	{
+		char buffer[ARBDate::MaxFormatLength];
+		ARBDate d(1999, 3, 2);
+		REQUIRE("19990302" == std::string(buffer, d.FormatTo(buffer, ARBDateFormat::YYYYMMDD)));
+		REQUIRE("03/02/1999" == std::string(buffer, d.FormatTo(buffer, ARBDateFormat::SlashMMDDYYYY)));
+		REQUIRE("2-3-1999" == std::string(buffer, d.FormatTo(buffer, ARBDateFormat::DashDMY)));
+		REQUIRE(0 == d.FormatTo(buffer, ARBDateFormat::Locale));
+		REQUIRE(0 == d.FormatTo(buffer, ARBDateFormat::Verbose));
+		REQUIRE(0 == ARBDate().FormatTo(buffer, ARBDateFormat::ISO));
+		// Every numeric format round trips.
+		for (int fmt = 1; fmt <= 12; ++fmt)
+		{
+			auto format = static_cast<ARBDateFormat>(fmt);
+			size_t len = d.FormatTo(buffer, format);
+			REQUIRE(d == ARBDate::Parse(std::string_view(buffer, len), format));
+		}
+	}
+
+
 	SECTION("Add")
 	{
 		ARBDate d1(1999, 3, 27);
@@ -182,6 +264,49 @@ TEST_CASE("Date")
 	}
 
 
+	SECTION("Parse")
+	{
+		ARBDate d(1999, 3, 27);
+		REQUIRE(d == ARBDate::Parse(L"1999-03-27", ARBDateFormat::DashYYYYMMDD));
+		REQUIRE(d == ARBDate::Parse(L"1999/3/27", ARBDateFormat::SlashYMD));
+		REQUIRE(d == ARBDate::Parse(L"03-27-1999", ARBDateFormat::DashMMDDYYYY));
+		REQUIRE(d == ARBDate::Parse(L"3/27/1999", ARBDateFormat::SlashMDY));
+		REQUIRE(d == ARBDate::Parse(L"27-3-1999", ARBDateFormat::DashDMY));
+		REQUIRE(d == ARBDate::Parse(L"27/03/1999", ARBDateFormat::SlashDDMMYYYY));
+		REQUIRE(d == ARBDate::Parse(std::string_view("1999-3-27"), ARBDateFormat::ISO));
+		REQUIRE(d == ARBDate::FromString(L"27/03/1999", ARBDateFormat::SlashDMY));
+		// Whitespace before a number and text after it are ignored.
+		REQUIRE(d == ARBDate::Parse(L" 1999 - 3 - 27 12:00", ARBDateFormat::ISO));
+
+		REQUIRE(!ARBDate::Parse(L"", ARBDateFormat::ISO).IsValid());
+		REQUIRE(!ARBDate::Parse(L"1999-3", ARBDateFormat::ISO).IsValid());
+		REQUIRE(!ARBDate::Parse(L"1999-3-27", ARBDateFormat::SlashYMD).IsValid());
+		REQUIRE(!ARBDate::Parse(L"1999--27", ARBDateFormat::ISO).IsValid());
+		REQUIRE(!ARBDate::Parse(L"1999-2-29", ARBDateFormat::ISO).IsValid());
+		REQUIRE(!ARBDate::Parse(L"1999-13-1", ARBDateFormat::ISO).IsValid());
+		REQUIRE(!ARBDate::Parse(L"1999-3-27", ARBDateFormat::SlashMDY).IsValid());
+		REQUIRE(!ARBDate::Parse(L"1000000-3-27", ARBDateFormat::ISO).IsValid());
+		REQUIRE(!ARBDate::Parse(L"19990327", ARBDateFormat::YYYYMMDD).IsValid());
+		REQUIRE(ARBDate::Parse(L"2000-2-29", ARBDateFormat::ISO).IsValid());
+	}
+
+
+	SECTION("ParseBatch")
+	{
+		std::string_view dates[] = {"1999-3-27", "bad", "2000-2-29", "2001-2-29"};
+		ARBDate parsed[4];
+		REQUIRE(2 == ARBDate::Parse(dates, 4, ARBDateFormat::ISO, parsed));
+		REQUIRE(parsed[0] == ARBDate(1999, 3, 27));
+		REQUIRE(!parsed[1].IsValid());
+		REQUIRE(parsed[2] == ARBDate(2000, 2, 29));
+		REQUIRE(!parsed[3].IsValid());
+
+		std::wstring_view wdates[] = {L"3/27/1999", L"12/31/2010"};
+		REQUIRE(2 == ARBDate::Parse(wdates, 2, ARBDateFormat::SlashMDY, parsed));
+		REQUIRE(parsed[1] == ARBDate(2010, 12, 31));
+	}
+
+
 #if !defined(__WXWINDOWS__)
 #pragma PRAGMA_TODO(need non - wx support in libarb - currently it asserts)
 #else
@@ -247,6 +372,135 @@ TEST_CASE("Date")
 	}
 
 
+	SECTION("Batch")
+	{
+		std::vector<long> days = {0, -1, ARBDate::MaxBatchJulian + 1};
+		for (long day = ARBDate(1995, 12, 25).GetJulianDay(); day < ARBDate(2030, 1, 7).GetJulianDay(); ++day)
+			days.push_back(day);
+		// The last few years of the supported range.
+		for (long day = ARBDate::MaxBatchJulian - 1500; day <= ARBDate::MaxBatchJulian; ++day)
+			days.push_back(day);
+		size_t const count = days.size();
+		std::vector<int> yr(count), mon(count), day(count), dayOfWeek(count), dayOfYear(count);
+		ARBDate::GetDates(days.data(), count, yr.data(), mon.data(), day.data());
+		ARBDate::GetDaysOfWeek(days.data(), count, dayOfWeek.data(), ARBDayOfWeek::Monday);
+		ARBDate::GetDaysOfYear(days.data(), count, dayOfYear.data());
+		for (size_t i = 0; i < 3; ++i)
+		{
+			REQUIRE(0 == yr[i]);
+			REQUIRE(0 == mon[i]);
+			REQUIRE(0 == day[i]);
+			REQUIRE(0 == dayOfWeek[i]);
+			REQUIRE(0 == dayOfYear[i]);
+		}
+		for (size_t i = 3; i < count; ++i)
+		{
+			ARBDate d;
+			d.SetJulianDay(days[i]);
+			REQUIRE(d == ARBDate(yr[i], mon[i], day[i]));
+			REQUIRE(d.GetDayOfWeek(ARBDayOfWeek::Monday) == dayOfWeek[i]);
+			REQUIRE(d.GetDayOfYear() == dayOfYear[i]);
+		}
+		REQUIRE(days[count - 2] == ARBDate::MaxBatchJulian - 1);
+		REQUIRE(days[count - 1] == ARBDate::MaxBatchJulian);
+		REQUIRE(0 < dayOfYear[count - 1]);
+		REQUIRE(0 < yr[count - 1]);
+	}
+
+
+	SECTION("CountByPeriod")
+	{
+		std::vector<long> days;
+		for (ARBDate d :
+			 {ARBDate(2009, 4, 11),
+			  ARBDate(2009, 4, 12),
+			  ARBDate(2009, 4, 13),
+			  ARBDate(2009, 5, 31),
+			  ARBDate(2011, 1, 1),
+			  ARBDate()})
+		{
+			days.push_back(d.GetJulianDay());
+		}
+		std::vector<ARBDatePeriodCount> counts;
+
+		ARBDate::CountByPeriod(days.data(), days.size(), ARBDatePeriod::Week, counts, ARBDayOfWeek::Sunday);
+		REQUIRE(counts.size() == 4);
+		REQUIRE(counts[0].start == ARBDate(2009, 4, 5));
+		REQUIRE(counts[0].count == 1);
+		REQUIRE(counts[1].start == ARBDate(2009, 4, 12));
+		REQUIRE(counts[1].count == 2);
+		REQUIRE(counts[2].start == ARBDate(2009, 5, 31));
+		REQUIRE(counts[3].start == ARBDate(2010, 12, 26));
+
+		ARBDate::CountByPeriod(days.data(), days.size(), ARBDatePeriod::Week, counts, ARBDayOfWeek::Monday);
+		REQUIRE(counts.size() == 4);
+		REQUIRE(counts[0].start == ARBDate(2009, 4, 6));
+		REQUIRE(counts[0].count == 2);
+		REQUIRE(counts[1].start == ARBDate(2009, 4, 13));
+		REQUIRE(counts[1].count == 1);
+
+		ARBDate::CountByPeriod(days.data(), days.size(), ARBDatePeriod::Month, counts);
+		REQUIRE(counts.size() == 3);
+		REQUIRE(counts[0].start == ARBDate(2009, 4, 1));
+		REQUIRE(counts[0].count == 3);
+		REQUIRE(counts[1].start == ARBDate(2009, 5, 1));
+		REQUIRE(counts[2].start == ARBDate(2011, 1, 1));
+
+		ARBDate::CountByPeriod(days.data(), days.size(), ARBDatePeriod::Year, counts);
+		REQUIRE(counts.size() == 2);
+		REQUIRE(counts[0].start == ARBDate(2009, 1, 1));
+		REQUIRE(counts[0].count == 4);
+		REQUIRE(counts[1].count == 1);
+
+		ARBDate::CountByPeriod(days.data(), 0, ARBDatePeriod::Year, counts);
+		REQUIRE(counts.empty());
+	}
+
+
+	SECTION("Today")
+	{
+		time_t now = time(nullptr);
+		ARBDate today = ARBDate::Today();
+		// Unless we just passed midnight...
+		if (today == ARBDate::Today())
+		{
+			REQUIRE(today == ARBDate(now));
+			ARBDate d;
+			d.SetToday();
+			REQUIRE(today == d);
+		}
+		REQUIRE(ARBDate(now - 10 * 24 * 60 * 60) < today);
+	}
+
+
+	SECTION("TodayThreads")
+	{
+		ARBDate today = ARBDate::Today();
+		std::vector<long> results(8);
+		std::vector<std::thread> threads;
+		for (size_t i = 0; i < results.size(); ++i)
+		{
+			threads.emplace_back([&results, i]() {
+				long julian = 0;
+				for (int n = 0; n < 10000; ++n)
+				{
+					julian = ARBDate::Today().GetJulianDay();
+					if (julian != ARBDate(time(nullptr)).GetJulianDay())
+						julian = 0;
+				}
+				results[i] = julian;
+			});
+		}
+		for (auto& thread : threads)
+			thread.join();
+		if (today == ARBDate::Today())
+		{
+			for (auto julian : results)
+				REQUIRE(julian == today.GetJulianDay());
+		}
+	}
+
+
 	SECTION("DSTDate")
 	{
 		ARBDate d1(2010, 6, 1);  // A date in DST
@@ -9,6 +9,7 @@
  * @brief Test UniqueId functions
  *
  * Revision History
+ * 2026-10-19 Test CreateMany, moves, hashing, Parse/FormatTo, binary.
  * 2022-10-05 Created
  */
 
@@ -16,6 +17,9 @@
 #include "TestARBLib.h"
 
 #include "ARBCommon/UniqueId.h"
+#include <set>
+#include <thread>
+#include <unordered_set>
 
 #ifdef __WXMSW__
 #include <wx/msw/msvcrt.h>
@@ -45,6 +49,75 @@ TEST_CASE("UniqueId")
 	}
 
 
+	SECTION("CreateMany")
+	{
+		std::vector<CUniqueId> ids = CUniqueId::CreateMany(10000);
+		REQUIRE(ids.size() == 10000);
+		std::set<CUniqueId> unique;
+		for (auto const& id : ids)
+		{
+			REQUIRE(!id.IsNull());
+			unique.insert(id);
+		}
+		REQUIRE(unique.size() == ids.size());
+		REQUIRE(CUniqueId::CreateMany(0).empty());
+	}
+
+
+	SECTION("Threads")
+	{
+		// Each thread has its own generator: they must not repeat each other.
+		std::vector<CUniqueId> ids[4];
+		std::vector<std::thread> threads;
+		for (auto& threadIds : ids)
+			threads.emplace_back([&threadIds]() { threadIds = CUniqueId::CreateMany(1000); });
+		for (auto& thread : threads)
+			thread.join();
+		std::set<CUniqueId> unique;
+		for (auto const& threadIds : ids)
+			unique.insert(threadIds.begin(), threadIds.end());
+		REQUIRE(unique.size() == 4000);
+	}
+
+
+	SECTION("Move")
+	{
+		CUniqueId id;
+		REQUIRE(id.Create());
+		wxString str = id.ToString();
+		CUniqueId id2(std::move(id));
+		REQUIRE(id2.ToString() == str);
+		CUniqueId id3;
+		id3 = std::move(id2);
+		REQUIRE(id3.ToString() == str);
+	}
+
+
+	SECTION("Hash")
+	{
+		CUniqueId id(L"fbec55d8-6243-4142-b534-0e96c9f12270");
+		CUniqueId id2(L"{FBEC55D8-6243-4142-B534-0E96C9F12270}");
+		REQUIRE(std::hash<CUniqueId>()(id) == std::hash<CUniqueId>()(id2));
+
+		// Ids differing in a single byte must not collide.
+		std::unordered_set<size_t> hashes;
+		for (int i = 0; i < 32; ++i)
+		{
+			wxString str(L"00000000000000000000000000000000");
+			str[i] = L'1';
+			hashes.insert(std::hash<CUniqueId>()(CUniqueId(str)));
+		}
+		REQUIRE(hashes.size() == 32);
+
+		std::unordered_set<CUniqueId> ids;
+		for (auto const& newId : CUniqueId::CreateMany(1000))
+			REQUIRE(ids.insert(newId).second);
+		REQUIRE(ids.insert(CUniqueId()).second);
+		REQUIRE(!ids.insert(CUniqueId()).second);
+		REQUIRE(ids.size() == 1001);
+	}
+
+
 	SECTION("clear")
 	{
 		CUniqueId id;
@@ -130,6 +203,87 @@ TEST_CASE("UniqueId")
 	}
 
 
+	SECTION("ParseView")
+	{
+		static const char* k_uuids[] = {
+			"fbec55d8-6243-4142-b534-0e96c9f12270",
+			"{fbec55d8-6243-4142-b534-0e96c9f12270}",
+			"fbec55d862434142b5340e96c9f12270",
+			"{FBEC55D862434142B5340E96C9F12270}",
+		};
+		CUniqueId expected(L"fbec55d8-6243-4142-b534-0e96c9f12270");
+		for (auto uuid : k_uuids)
+		{
+			CUniqueId id;
+			REQUIRE(id.Parse(std::string_view(uuid)));
+			REQUIRE(id == expected);
+			CUniqueId id2;
+			REQUIRE(id2.Parse(std::wstring_view(wxString(uuid).wc_str())));
+			REQUIRE(id2 == expected);
+		}
+
+		static const char* k_bad[] = {
+			"",
+			"{",
+			"{}",
+			"fbec55d8-6243-4142-b534-0e96c9f1227",
+			"fbec55d8-6243-4142-b534-0e96c9f122700",
+			"{fbec55d8-6243-4142-b534-0e96c9f12270",
+			"fbec55d8-6243-4142-b534-0e96c9f1227g",
+			"00000000-0000-0000-0000-000000000000",
+		};
+		for (auto uuid : k_bad)
+		{
+			CUniqueId id(expected);
+			REQUIRE(!id.Parse(std::string_view(uuid)));
+			REQUIRE(id.IsNull());
+		}
+		// Not ASCII, but the low byte is a hex digit.
+		CUniqueId id(expected);
+		std::wstring wide(L"fbec55d8-6243-4142-b534-0e96c9f12270");
+		wide[0] = static_cast<wchar_t>(0x100 + 'f');
+		REQUIRE(!id.Parse(wide));
+	}
+
+
+	SECTION("FormatTo")
+	{
+		CUniqueId id(L"{FBEC55D8-6243-4142-B534-0E96C9F12270}");
+		char buffer[CUniqueId::StringLength];
+		REQUIRE(id.FormatTo(buffer) == CUniqueId::StringLength);
+		REQUIRE(std::string_view(buffer, CUniqueId::StringLength) == "fbec55d8-6243-4142-b534-0e96c9f12270");
+		wchar_t wbuffer[CUniqueId::StringLength];
+		REQUIRE(id.FormatTo(wbuffer) == CUniqueId::StringLength);
+		REQUIRE(std::wstring_view(wbuffer, CUniqueId::StringLength) == L"fbec55d8-6243-4142-b534-0e96c9f12270");
+
+		for (auto const& newId : CUniqueId::CreateMany(100))
+		{
+			REQUIRE(newId.FormatTo(buffer) == CUniqueId::StringLength);
+			CUniqueId id2;
+			REQUIRE(id2.Parse(std::string_view(buffer, CUniqueId::StringLength)));
+			REQUIRE(id2 == newId);
+			REQUIRE(newId.ToString() == wxString(buffer, CUniqueId::StringLength));
+		}
+	}
+
+
+	SECTION("Binary")
+	{
+		CUniqueId id(L"fbec55d8-6243-4142-b534-0e96c9f12270");
+		unsigned char buffer[CUniqueId::BinarySize];
+		id.WriteBinary(buffer);
+		REQUIRE(buffer[0] == 0xfb);
+		REQUIRE(buffer[15] == 0x70);
+		CUniqueId id2;
+		REQUIRE(id2.ReadBinary(buffer));
+		REQUIRE(id == id2);
+
+		unsigned char zero[CUniqueId::BinarySize] = {};
+		REQUIRE(!id2.ReadBinary(zero));
+		REQUIRE(id2.IsNull());
+	}
+
+
 	SECTION("ParseEquality")
 	{
 		const wchar_t* uuid = L"fbec55d8-6243-4142-b534-0e96c9f12270";
@@ -10,6 +10,12 @@
  * @author David Connet
  *
  * Revision History
+ * 2026-10-19 Added stream exception test.
+ * 2026-10-19 Added digest cache tests.
+ * 2026-10-19 Added file tests.
+ * 2026-10-19 Added SHA384, SHA512, XXH64 tests.
+ * 2026-10-19 Added multi-digest tests.
+ * 2026-10-19 Added batch tests.
  * 2017-11-09 Convert from UnitTest++ to Catch
  * 2010-02-07 Created
  */
@@ -18,7 +24,10 @@
 #include "TestARBLib.h"
 
 #include "ARBCommon/ARBMsgDigest.h"
+#include "ARBCommon/ARBMsgDigestCache.h"
 #include <sstream>
+#include <wx/ffile.h>
+#include <wx/filename.h>
 
 #ifdef __WXMSW__
 #include <wx/msw/msvcrt.h>
@@ -37,6 +46,11 @@ TEST_CASE("MsgDigest")
 	static wxString DigestStringMD5(L"b36b52c4835d88fdb548087b9a829bf1");
 	static wxString DigestStringSHA1(L"7d56b53d54b141cb77e465abcfe63436a35ae222");
 	static wxString DigestStringSHA256(L"5d2819684143b99d8b9c9a254e1b5584529a3fe947862e8ae15e246eda292c37");
+	static wxString DigestStringSHA384(
+		L"3fc47c54236ff960538aaa7e0844576c620bcfefb01ffd8f77ae866aa5133760230a472b69e82bd85ebe9c438e9d50ca");
+	static wxString DigestStringSHA512(
+		L"b4e99f9e1d24ba296e8cc9c249f93383860acb1d07921b4b44408e0be73c16667a3fb521e8e1affa95efc6acaa8a291d893ccb27e58bed5b2cd179b6cf4e3b7b");
+	static wxString DigestStringXXH64(L"6f5c2d75ede34dd8");
 
 
 	SECTION("RawDecode")
@@ -61,6 +75,259 @@ TEST_CASE("MsgDigest")
 		wxString digest = ARBMsgDigest::Compute(buffer, ARBMsgDigest::ARBDigest::SHA256);
 		REQUIRE(digest == DigestStringSHA256);
 	}
+
+
+	SECTION("RawDecodeSha384")
+	{
+		std::stringstream buffer(RawString);
+		wxString digest = ARBMsgDigest::Compute(buffer, ARBMsgDigest::ARBDigest::SHA384);
+		REQUIRE(digest == DigestStringSHA384);
+	}
+
+
+	SECTION("RawDecodeSha512")
+	{
+		std::stringstream buffer(RawString);
+		wxString digest = ARBMsgDigest::Compute(buffer, ARBMsgDigest::ARBDigest::SHA512);
+		REQUIRE(digest == DigestStringSHA512);
+	}
+
+
+	SECTION("RawDecodeXXH64")
+	{
+		std::stringstream buffer(RawString);
+		wxString digest = ARBMsgDigest::Compute(buffer, ARBMsgDigest::ARBDigest::XXH64);
+		REQUIRE(digest == DigestStringXXH64);
+
+		std::stringstream empty;
+		REQUIRE(ARBMsgDigest::Compute(empty, ARBMsgDigest::ARBDigest::XXH64) == L"ef46db3751d8e999");
+
+		// Longer than a stripe and not a multiple of the read size.
+		std::string data;
+		for (int i = 0; i < 1000; ++i)
+			data += std::to_string(i);
+		std::stringstream buffer2(data);
+		REQUIRE(ARBMsgDigest::Compute(buffer2, ARBMsgDigest::ARBDigest::XXH64) == L"ea2e44efe1610077");
+	}
+
+
+	SECTION("MultiDigest")
+	{
+		std::set<ARBMsgDigest::ARBDigest> types{
+			ARBMsgDigest::ARBDigest::MD5,
+			ARBMsgDigest::ARBDigest::SHA1,
+			ARBMsgDigest::ARBDigest::SHA256};
+		for (bool bThreaded : {false, true})
+		{
+			std::stringstream buffer(RawString);
+			size_t size = 0;
+			auto digests = ARBMsgDigest::Compute(buffer, types, &size, bThreaded);
+			REQUIRE(digests.size() == 3);
+			REQUIRE(digests[ARBMsgDigest::ARBDigest::MD5] == DigestStringMD5);
+			REQUIRE(digests[ARBMsgDigest::ARBDigest::SHA1] == DigestStringSHA1);
+			REQUIRE(digests[ARBMsgDigest::ARBDigest::SHA256] == DigestStringSHA256);
+			REQUIRE(size == strlen(RawString));
+		}
+	}
+
+
+	SECTION("MultiDigestLarge")
+	{
+		// Spans several read blocks, so the threaded ring wraps around.
+		std::string data;
+		for (int i = 0; data.size() < 3 * 1024 * 1024; ++i)
+			data += std::to_string(i);
+		std::set<ARBMsgDigest::ARBDigest> types{ARBMsgDigest::ARBDigest::MD5, ARBMsgDigest::ARBDigest::SHA256};
+		std::stringstream buffer1(data);
+		auto digests1 = ARBMsgDigest::Compute(buffer1, types, nullptr, false);
+		std::stringstream buffer2(data);
+		auto digests2 = ARBMsgDigest::Compute(buffer2, types, nullptr, true);
+		REQUIRE(digests1 == digests2);
+		std::stringstream buffer3(data);
+		REQUIRE(digests1[ARBMsgDigest::ARBDigest::SHA256] == ARBMsgDigest::Compute(buffer3, ARBMsgDigest::ARBDigest::SHA256));
+	}
+
+
+	SECTION("MultiDigestThrow")
+	{
+		// A stream that fails (with exceptions enabled) after a few blocks.
+		class FailingBuf : public std::streambuf
+		{
+		public:
+			FailingBuf()
+				: m_data(256 * 1024, 'x')
+				, m_count(0)
+			{
+			}
+
+		protected:
+			int_type underflow() override
+			{
+				if (10 <= m_count++)
+					throw std::runtime_error("read failed");
+				setg(m_data.data(), m_data.data(), m_data.data() + m_data.size());
+				return traits_type::to_int_type(m_data[0]);
+			}
+
+		private:
+			std::vector<char> m_data;
+			int m_count;
+		};
+		std::set<ARBMsgDigest::ARBDigest> types{ARBMsgDigest::ARBDigest::MD5, ARBMsgDigest::ARBDigest::SHA256};
+		for (bool bThreaded : {false, true})
+		{
+			FailingBuf buf;
+			std::istream stream(&buf);
+			stream.exceptions(std::ios::badbit);
+			REQUIRE_THROWS(ARBMsgDigest::Compute(stream, types, nullptr, bThreaded));
+		}
+	}
+
+
+	SECTION("SmallStreamBuffer")
+	{
+		std::stringstream buffer(RawString);
+		size_t size = 0;
+		wxString digest = ARBMsgDigest::Compute(buffer, ARBMsgDigest::ARBDigest::SHA256, &size, 3);
+		REQUIRE(digest == DigestStringSHA256);
+		REQUIRE(size == strlen(RawString));
+	}
+
+
+	SECTION("File")
+	{
+		std::string data;
+		for (int i = 0; data.size() < 200000; ++i)
+			data += std::to_string(i);
+		wxString filename = wxFileName::CreateTempFileName(L"arb");
+		{
+			wxFFile file(filename, L"wb");
+			REQUIRE(file.IsOpened());
+			REQUIRE(file.Write(data.data(), data.size()) == data.size());
+		}
+		std::stringstream buffer(data);
+		wxString digestStream = ARBMsgDigest::Compute(buffer, ARBMsgDigest::ARBDigest::SHA1);
+		size_t size = 0;
+		wxString digestFile = ARBMsgDigest::Compute(filename, ARBMsgDigest::ARBDigest::SHA1, &size);
+		wxRemoveFile(filename);
+		REQUIRE(!digestFile.empty());
+		REQUIRE(digestFile == digestStream);
+		REQUIRE(size == data.size());
+	}
+
+
+	SECTION("BatchStreams")
+	{
+		std::vector<std::stringstream> buffers(10);
+		std::vector<std::istream*> streams;
+		for (auto& buffer : buffers)
+		{
+			buffer.str(RawString);
+			streams.push_back(&buffer);
+		}
+		auto results = ARBMsgDigest::ComputeMany(streams, ARBMsgDigest::ARBDigest::SHA256, 4);
+		REQUIRE(results.size() == streams.size());
+		for (auto const& result : results)
+		{
+			REQUIRE(result.error == ARBMsgDigest::ARBDigestError::None);
+			REQUIRE(result.digest == DigestStringSHA256);
+			REQUIRE(result.size == strlen(RawString));
+		}
+	}
+
+
+	SECTION("BatchFiles")
+	{
+		std::vector<wxString> files;
+		files.push_back(L"this/file/does/not.exist");
+		auto results = ARBMsgDigest::ComputeMany(files, ARBMsgDigest::ARBDigest::MD5);
+		REQUIRE(results.size() == 1);
+		REQUIRE(results[0].error == ARBMsgDigest::ARBDigestError::OpenFailed);
+		REQUIRE(results[0].digest.empty());
+	}
+}
+
+
+TEST_CASE("MsgDigestCache")
+{
+	constexpr char RawString[] = "This is a test of a string";
+	static wxString DigestStringSHA256(L"5d2819684143b99d8b9c9a254e1b5584529a3fe947862e8ae15e246eda292c37");
+
+	wxString cacheFile = wxFileName::CreateTempFileName(L"arbcache");
+	wxRemoveFile(cacheFile);
+	wxString dataFile = wxFileName::CreateTempFileName(L"arbdata");
+	{
+		wxFFile file(dataFile, L"wb");
+		REQUIRE(file.IsOpened());
+		file.Write(RawString, strlen(RawString));
+	}
+
+	SECTION("Reuse")
+	{
+		{
+			ARBMsgDigest::ARBDigestCache cache(cacheFile);
+			wxString digest;
+			REQUIRE(!cache.Lookup(dataFile, ARBMsgDigest::ARBDigest::SHA256, digest));
+			size_t size = 0;
+			REQUIRE(cache.Compute(dataFile, ARBMsgDigest::ARBDigest::SHA256, &size) == DigestStringSHA256);
+			REQUIRE(size == strlen(RawString));
+			REQUIRE(cache.Lookup(dataFile, ARBMsgDigest::ARBDigest::SHA256, digest));
+			REQUIRE(digest == DigestStringSHA256);
+			REQUIRE(cache.Flush());
+		}
+		// A second instance (or process) sees the entry.
+		ARBMsgDigest::ARBDigestCache cache(cacheFile);
+		REQUIRE(cache.size() == 1);
+		wxString digest;
+		size_t size = 0;
+		REQUIRE(cache.Lookup(dataFile, ARBMsgDigest::ARBDigest::SHA256, digest, &size));
+		REQUIRE(digest == DigestStringSHA256);
+		REQUIRE(size == strlen(RawString));
+		REQUIRE(!cache.Lookup(dataFile, ARBMsgDigest::ARBDigest::MD5, digest));
+	}
+
+	SECTION("Changed")
+	{
+		ARBMsgDigest::ARBDigestCache cache(cacheFile);
+		REQUIRE(cache.Compute(dataFile, ARBMsgDigest::ARBDigest::SHA256) == DigestStringSHA256);
+		{
+			wxFFile file(dataFile, L"ab");
+			file.Write("x", 1);
+		}
+		wxString digest;
+		REQUIRE(!cache.Lookup(dataFile, ARBMsgDigest::ARBDigest::SHA256, digest));
+		REQUIRE(cache.Compute(dataFile, ARBMsgDigest::ARBDigest::SHA256) != DigestStringSHA256);
+	}
+
+	SECTION("Shared")
+	{
+		ARBMsgDigest::ARBDigestCache cache1(cacheFile);
+		ARBMsgDigest::ARBDigestCache cache2(cacheFile);
+		cache1.Compute(dataFile, ARBMsgDigest::ARBDigest::SHA256);
+		cache2.Compute(dataFile, ARBMsgDigest::ARBDigest::MD5);
+		REQUIRE(cache1.Flush());
+		REQUIRE(cache2.Flush());
+		REQUIRE(cache1.Flush());
+		REQUIRE(cache2.size() == 2);
+	}
+
+	SECTION("Compact")
+	{
+		ARBMsgDigest::ARBDigestCache cache(cacheFile);
+		cache.Compute(dataFile, ARBMsgDigest::ARBDigest::SHA256);
+		cache.Compute(dataFile, ARBMsgDigest::ARBDigest::MD5);
+		REQUIRE(cache.Flush());
+		REQUIRE(cache.size() == 2);
+		wxRemoveFile(dataFile);
+		REQUIRE(cache.Compact());
+		REQUIRE(cache.size() == 0);
+		ARBMsgDigest::ARBDigestCache cache2(cacheFile);
+		REQUIRE(cache2.size() == 0);
+	}
+
+	wxRemoveFile(dataFile);
+	wxRemoveFile(cacheFile);
+	wxRemoveFile(cacheFile + L".lock");
 }
 
 } // namespace dconSoft